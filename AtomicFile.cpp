@@ -0,0 +1,161 @@
+#include "AtomicFile.hpp"
+#include "Logger.hpp"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+bool writeAll(int fd, std::string_view data) {
+    const char* p = data.data();
+    size_t left = data.size();
+    while (left > 0) {
+        ssize_t written = ::write(fd, p, left);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += written;
+        left -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// `error`: errno của bước thất bại, lưu ngay sau lời gọi đó (trước ::close() có thể đổi errno)
+bool fail(const std::string& filename, const std::string& temp, const char* step, int error) {
+    std::cerr << "Error: Could not save file: " << filename << " (" << step << ": " << std::strerror(error) << ")\n";
+    Logger::getInstance().log("Failed to save " + filename + " (" + step + ": " + std::strerror(error) + ")",
+                              LogLevel::Error);
+    ::unlink(temp.c_str());
+    return false;
+}
+
+} // namespace
+
+// fsync thư mục chứa `filename` để phép rename cũng được ghi xuống đĩa
+bool syncParentDirectory(const std::string& filename) {
+    size_t slash = filename.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : filename.substr(0, slash));
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+bool writeTempFile(const std::string& filename, const std::string& temp,
+                   std::initializer_list<std::string_view> parts) {
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return fail(filename, temp, "open", errno);
+    }
+    for (std::string_view part : parts) {
+        if (!writeAll(fd, part)) {
+            int error = errno;
+            ::close(fd);
+            return fail(filename, temp, "write", error);
+        }
+    }
+    if (::fsync(fd) != 0) {
+        int error = errno;
+        ::close(fd);
+        return fail(filename, temp, "fsync", error);
+    }
+    if (::close(fd) != 0) {
+        return fail(filename, temp, "close", errno);
+    }
+    return true;
+}
+
+bool renameTempFile(const std::string& filename, const std::string& temp) {
+    if (std::rename(temp.c_str(), filename.c_str()) != 0) {
+        return fail(filename, temp, "rename", errno);
+    }
+    return true;
+}
+
+bool writeFileAtomic(const std::string& filename, std::initializer_list<std::string_view> parts) {
+    const std::string temp = filename + ".tmp";
+    if (!writeTempFile(filename, temp, parts) || !renameTempFile(filename, temp)) {
+        return false;
+    }
+    if (!syncParentDirectory(filename)) {
+        // Nội dung đã đúng chỗ; chỉ chưa chắc phép rename còn sau khi mất điện
+        Logger::getInstance().log("Failed to fsync directory of " + filename, LogLevel::Error);
+    }
+    return true;
+}
+
+void FileDigest::update(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash_ ^= static_cast<unsigned char>(data[i]);
+        hash_ *= 1099511628211ULL;
+    }
+    size_ += size;
+}
+
+std::string FileDigest::text() const {
+    char line[64];
+    std::snprintf(line, sizeof(line), "fnv1a64 %016llx %llu\n", static_cast<unsigned long long>(hash_),
+                  static_cast<unsigned long long>(size_));
+    return line;
+}
+
+bool writeFileAtomicWithDigest(const std::string& filename, std::initializer_list<std::string_view> parts) {
+    FileDigest digest;
+    for (std::string_view part : parts) {
+        digest.update(part);
+    }
+    const std::string temp = filename + ".tmp";
+    const std::string sum = digestFilename(filename);
+    const std::string sumTemp = sum + ".tmp";
+    if (!writeTempFile(filename, temp, parts)) {
+        return false;
+    }
+    if (!writeTempFile(sum, sumTemp, {digest.text()})) {
+        std::remove(temp.c_str());
+        return false;
+    }
+    if (!renameTempFile(filename, temp)) {
+        std::remove(sumTemp.c_str());
+        return false;
+    }
+    if (!renameTempFile(sum, sumTemp)) {
+        std::remove(sum.c_str()); // Tóm tắt cũ không còn đúng với nội dung mới
+    }
+    if (!syncParentDirectory(filename)) {
+        Logger::getInstance().log("Failed to fsync directory of " + filename, LogLevel::Error);
+    }
+    return true;
+}
+
+bool digestMatches(const std::string& filename, const FileDigest& digest) {
+    std::ifstream file(digestFilename(filename), std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string stored((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return stored == digest.text();
+}
+
+bool verifyFileDigest(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    FileDigest digest;
+    std::vector<char> buffer(1 << 16);
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        digest.update(buffer.data(), static_cast<size_t>(file.gcount()));
+    }
+    return digestMatches(filename, digest);
+}
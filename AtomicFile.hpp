@@ -0,0 +1,65 @@
+#ifndef ATOMIC_FILE_HPP_
+#define ATOMIC_FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+// Ghi đè file một cách an toàn khi crash: nội dung được ghi vào `filename + ".tmp"`,
+// fsync, đổi tên (rename) đè lên file đích rồi fsync thư mục chứa nó. Sau khi hàm trả
+// về true, file đích chứa đầy đủ nội dung mới kể cả khi mất điện; nếu crash giữa chừng,
+// file đích vẫn là bản cũ nguyên vẹn (file .tmp bỏ dở sẽ bị ghi đè ở lần lưu sau).
+//
+// Các phần trong `parts` được ghi nối tiếp nhau, không cần ghép thành một chuỗi.
+// Trả về false (file đích giữ nguyên) nếu có lỗi; lỗi được ghi vào log.
+bool writeFileAtomic(const std::string& filename, std::initializer_list<std::string_view> parts);
+
+inline bool writeFileAtomic(const std::string& filename, std::string_view content) {
+    return writeFileAtomic(filename, {content});
+}
+
+// Các bước của writeFileAtomic, cho nơi cần ghi và fsync file tạm ngoài khóa, chỉ giữ khóa
+// lúc đổi tên. writeTempFile ghi `parts` vào `temp` và fsync; renameTempFile đổi tên `temp`
+// đè lên `filename`; syncParentDirectory fsync thư mục chứa `filename` để phép rename bền.
+// Khi lỗi: trả về false, file tạm bị xóa và lỗi được ghi vào log như writeFileAtomic.
+bool writeTempFile(const std::string& filename, const std::string& temp,
+                   std::initializer_list<std::string_view> parts);
+bool renameTempFile(const std::string& filename, const std::string& temp);
+bool syncParentDirectory(const std::string& filename);
+
+// Tóm tắt nội dung file (FNV-1a 64 và kích thước), lưu cạnh file trong digestFilename().
+// Loader so với tóm tắt để biết file đúng là bản chương trình đã ghi trọn vẹn (không bị sửa
+// từ bên ngoài hay hỏng) trước khi bỏ qua bước kiểm tra lại nội dung.
+class FileDigest {
+public:
+    void update(const char* data, size_t size);
+    void update(std::string_view data) { update(data.data(), data.size()); }
+    std::string text() const;
+
+private:
+    uint64_t hash_ = 14695981039346656037ULL;
+    uint64_t size_ = 0;
+};
+
+inline std::string digestFilename(const std::string& filename) {
+    return filename + ".sum";
+}
+
+// Như writeFileAtomic, kèm file tóm tắt: cả hai file tạm được ghi và fsync trước, rồi mới đổi
+// tên nội dung và sau đó tóm tắt. Crash giữa hai lần đổi tên để lại tóm tắt cũ không khớp,
+// nên loader chỉ mất đường nhanh chứ không tin nhầm file.
+bool writeFileAtomicWithDigest(const std::string& filename, std::initializer_list<std::string_view> parts);
+
+inline bool writeFileAtomicWithDigest(const std::string& filename, std::string_view content) {
+    return writeFileAtomicWithDigest(filename, {content});
+}
+
+// File tóm tắt của `filename` có khớp `digest` không (false nếu không có file tóm tắt)
+bool digestMatches(const std::string& filename, const FileDigest& digest);
+
+// Đọc toàn bộ `filename` rồi so với file tóm tắt của nó; dùng cho các file nhỏ
+bool verifyFileDigest(const std::string& filename);
+
+#endif // ATOMIC_FILE_HPP_
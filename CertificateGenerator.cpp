@@ -3,14 +3,8 @@
 #include <iostream>
 #include <sstream>
 
-// Function to generate certificate in Markdown format
-bool generateCertificateMarkdown(const CertificateData &data, const std::string &outputFile) {
-    std::ofstream out(outputFile);
-    if (!out.is_open()) {
-        std::cerr << "Error: Cannot open output file for Markdown generation.\n";
-        return false;
-    }
-
+// Function to write certificate in Markdown format
+void writeCertificateMarkdown(const CertificateData &data, std::ostream &out) {
     // Header with school and contact info
     out << "# TRƯỜNG ĐẠI HỌC " << data.schoolName << "\n";
     out << "## PHÒNG ĐÀO TẠO\n\n";
@@ -47,18 +41,10 @@ bool generateCertificateMarkdown(const CertificateData &data, const std::string
     out << "**Ngày cấp:** " << data.issueDate << "\n\n";
     out << "**Trưởng Phòng Đào Tạo**  \n";
     out << "(Ký, ghi rõ họ tên, đóng dấu)\n";
-
-    out.close();
-    return true;
 }
 
-// Hàm tạo giấy xác nhận ở định dạng DOCX (ví dụ đơn giản bằng cách ghi file văn bản)
-bool generateCertificateDOCX(const CertificateData &data, const std::string &outputFile) {
-    std::ofstream out(outputFile);
-    if (!out.is_open()) {
-        std::cerr << "Error: Cannot open output file for DOCX generation.\n";
-        return false;
-    }
+// Hàm ghi giấy xác nhận ở định dạng DOCX (ví dụ đơn giản bằng cách ghi văn bản)
+void writeCertificateDOCX(const CertificateData &data, std::ostream &out) {
     out << "TRƯỜNG ĐẠI HỌC " << data.schoolName << "\n";
     out << "PHÒNG ĐÀO TẠO\n";
     out << "📍 Địa chỉ: " << data.schoolAddress << "\n";
@@ -89,16 +75,52 @@ bool generateCertificateDOCX(const CertificateData &data, const std::string &out
     out << "Ngày cấp: " << data.issueDate << "\n";
     out << "Trưởng Phòng Đào Tạo\n";
     out << "(Ký, ghi rõ họ tên, đóng dấu)\n";
-    out.close();
-    return true;
+}
+
+std::string renderCertificate(const CertificateData &data, CertificateFormat format) {
+    std::ostringstream out;
+    if (format == CertificateFormat::MD) {
+        writeCertificateMarkdown(data, out);
+    } else {
+        writeCertificateDOCX(data, out);
+    }
+    return out.str();
 }
 
 // Hàm tổng hợp để tạo giấy xác nhận theo định dạng đã chọn
 bool generateCertificate(const CertificateData &data, const std::string &outputFile, CertificateFormat format) {
-    if (format == CertificateFormat::MD) {
-        return generateCertificateMarkdown(data, outputFile);
-    } else if (format == CertificateFormat::DOCX) {
-        return generateCertificateDOCX(data, outputFile);
+    std::ofstream out(outputFile);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot open output file for certificate generation.\n";
+        return false;
     }
-    return false;
+    out << renderCertificate(data, format);
+    out.close();
+    return static_cast<bool>(out);
+}
+
+std::string translateStatus(const std::string &status) {
+    if (status == "Active") {
+        return "Đang theo học";
+    } else if (status == "Graduated") {
+        return "Đã tốt nghiệp";
+    } else if (status == "Leave") {
+        return "Bảo lưu";
+    } else if (status == "Absent") {
+        return "Vắng mặt";
+    } else if (status == "Post-graduated") {
+        return "Sau tốt nghiệp";
+    } else {
+        return status; // Nếu không khớp, trả về giá trị ban đầu
+    }
+}
+
+CertificateData defaultCertificateData() {
+    CertificateData data;
+    // Thông tin trường (có thể thay đổi theo cấu hình)
+    data.schoolName    = "KHOA HỌC TỰ NHIÊN";
+    data.schoolAddress = "227 NGUYỄN VĂN CỪ, PHƯỜNG 4, QUẬN 5 TP.HCM";
+    data.schoolPhone   = "(028) 38353448";
+    data.schoolEmail   = "contact@hcmus.edu.vn";
+    return data;
 }
@@ -36,4 +36,13 @@ enum class CertificateFormat {
 // Hàm tạo giấy xác nhận với định dạng được chọn
 bool generateCertificate(const CertificateData &data, const std::string &outputFile, CertificateFormat format);
 
+// Nội dung giấy xác nhận (như trong file do generateCertificate tạo), không ghi file
+std::string renderCertificate(const CertificateData &data, CertificateFormat format);
+
+// Dịch tình trạng sinh viên từ tiếng Anh sang tiếng Việt (giữ nguyên nếu không biết)
+std::string translateStatus(const std::string &status);
+
+// CertificateData đã điền sẵn thông tin trường
+CertificateData defaultCertificateData();
+
 #endif // CERTIFICATE_GENERATOR_HPP_
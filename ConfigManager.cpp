@@ -1,4 +1,5 @@
 #include "ConfigManager.hpp"
+#include "AtomicFile.hpp"
 
 ConfigManager::ConfigManager() : configFilename("config.json") {
     loadConfig(configFilename);
@@ -16,6 +17,22 @@ void ConfigManager::loadConfig(const std::string& filename) {
             phoneRegex = j.value("phoneRegex", phoneRegex);
             deleteTimeLimit_ = j.value("deleteTimeLimit", deleteTimeLimit_);
             enforceValidation_ = j.value("enforceValidation", enforceValidation_);
+            storageFormat_ = j.value("storageFormat", storageFormat_);
+            if (!parseJsonOutputStyle(j.value("jsonOutputStyle", jsonOutputStyleName(jsonOutputStyle_)), jsonOutputStyle_)) {
+                std::cerr << "jsonOutputStyle không hợp lệ (pretty/compact/lines), giữ kiểu "
+                          << jsonOutputStyleName(jsonOutputStyle_) << std::endl;
+            }
+            importThreads_ = j.value("importThreads", importThreads_);
+            persistIntervalMs_ = j.value("persistIntervalMs", persistIntervalMs_);
+            serverPort_ = j.value("serverPort", serverPort_);
+            serverThreads_ = j.value("serverThreads", serverThreads_);
+            journalMode_ = j.value("journalMode", journalMode_);
+            journalGroupSize_ = j.value("journalGroupSize", journalGroupSize_);
+            journalCompactThreshold_ = j.value("journalCompactThreshold", journalCompactThreshold_);
+            if (!verifyFileDigest(filename)) {
+                checkLoadedValues(); // Không phải bản saveConfig() đã ghi: không tin các giá trị
+            }
+            ++revision_;
         } catch (const json::exception& e) {
             std::cerr << "Lỗi khi parse config: " << e.what() << std::endl;
         }
@@ -25,6 +42,27 @@ void ConfigManager::loadConfig(const std::string& filename) {
     }
 }
 
+// Đưa các giá trị nằm ngoài miền hợp lệ về mặc định
+void ConfigManager::checkLoadedValues() {
+    auto check = [](const char* key, int& value, bool valid, int fallback) {
+        if (!valid) {
+            std::cerr << key << " không hợp lệ (" << value << "), dùng " << fallback << std::endl;
+            value = fallback;
+        }
+    };
+    check("deleteTimeLimit", deleteTimeLimit_, deleteTimeLimit_ >= 0, 1);
+    check("importThreads", importThreads_, importThreads_ >= 0, 0);
+    check("persistIntervalMs", persistIntervalMs_, persistIntervalMs_ >= 0, 500);
+    check("serverPort", serverPort_, serverPort_ > 0 && serverPort_ <= 65535, 8080);
+    check("serverThreads", serverThreads_, serverThreads_ >= 0, 0);
+    check("journalGroupSize", journalGroupSize_, journalGroupSize_ > 0, 64);
+    check("journalCompactThreshold", journalCompactThreshold_, journalCompactThreshold_ > 0, 10000);
+    if (storageFormat_ != "json" && storageFormat_ != "binary") {
+        std::cerr << "storageFormat không hợp lệ (" << storageFormat_ << "), dùng json" << std::endl;
+        storageFormat_ = "json";
+    }
+}
+
 // Lưu cấu hình vào file
 void ConfigManager::saveConfig() {
     json j;
@@ -32,13 +70,19 @@ void ConfigManager::saveConfig() {
     j["phoneRegex"] = phoneRegex;
     j["deleteTimeLimit"] = deleteTimeLimit_;
     j["enforceValidation"] = enforceValidation_;
-    std::ofstream file(configFilename);
-    if (file.is_open()) {
-        file << std::setw(4) << j << std::endl;
-        file.close();
+    j["storageFormat"] = storageFormat_;
+    j["jsonOutputStyle"] = jsonOutputStyleName(jsonOutputStyle_);
+    j["importThreads"] = importThreads_;
+    j["persistIntervalMs"] = persistIntervalMs_;
+    j["serverPort"] = serverPort_;
+    j["serverThreads"] = serverThreads_;
+    j["journalMode"] = journalMode_;
+    j["journalGroupSize"] = journalGroupSize_;
+    j["journalCompactThreshold"] = journalCompactThreshold_;
+    if (writeFileAtomicWithDigest(configFilename, dumpJson(j, jsonOutputStyle_))) {
         std::cout << "Lưu cấu hình thành công vào file: " << configFilename << "\n";
     } else {
-        std::cerr << "Lỗi mở file config để ghi: " << configFilename << std::endl;
+        std::cerr << "Lỗi ghi file config: " << configFilename << std::endl;
     }
 }
 
@@ -7,6 +7,7 @@
 #include <sstream>
 #include <iomanip>
 #include "nlohmann/json.hpp"
+#include "JsonFormat.hpp"
 
 using json = nlohmann::json;
 
@@ -25,23 +26,71 @@ public:
     }
 
     // Setters & Getters
-    void setEmailSuffix(const std::string& suffix) { emailSuffix = suffix; }
-    void setPhoneRegex(const std::string& regex) { phoneRegex = regex; }
+    void setEmailSuffix(const std::string& suffix) { emailSuffix = suffix; ++revision_; }
+    void setPhoneRegex(const std::string& regex) { phoneRegex = regex; ++revision_; }
     void setEnforceValidation(bool flag) { enforceValidation_ = flag; }
     bool getEnforceValidation() const { return enforceValidation_; }
     std::string getEmailSuffix() const { return emailSuffix; }
     std::string getPhoneRegex() const { return phoneRegex; }
 
+    // Tăng mỗi khi emailSuffix/phoneRegex thay đổi, để nơi dùng biết khi nào cần biên dịch lại
+    unsigned long getRevision() const { return revision_; }
+
+    // Định dạng lưu dữ liệu sinh viên: "json" (students.json) hoặc "binary" (students.bin)
+    void setStorageFormat(const std::string& format) { storageFormat_ = format; }
+    std::string getStorageFormat() const { return storageFormat_; }
+
+    // Kiểu ghi các file JSON (dữ liệu sinh viên, danh mục, config, quy luật, xuất JSON)
+    void setJsonOutputStyle(JsonOutputStyle style) { jsonOutputStyle_ = style; }
+    JsonOutputStyle getJsonOutputStyle() const { return jsonOutputStyle_; }
+
+    // Số luồng kiểm tra khi nhập hàng loạt (0: theo số lõi của máy)
+    void setImportThreads(int threads) { importThreads_ = threads; }
+    int getImportThreads() const { return importThreads_; }
+
+    // Độ trễ (ms) trước khi các file dữ liệu đã thay đổi được ghi nền; các thay đổi
+    // trong khoảng này được gộp thành một lần ghi
+    void setPersistIntervalMs(int ms) { persistIntervalMs_ = ms; }
+    int getPersistIntervalMs() const { return persistIntervalMs_; }
+
+    // Chế độ máy chủ (--serve): cổng lắng nghe trên 127.0.0.1 và số luồng xử lý yêu cầu
+    // (0: theo số lõi của máy)
+    void setServerPort(int port) { serverPort_ = port; }
+    int getServerPort() const { return serverPort_; }
+    void setServerThreads(int threads) { serverThreads_ = threads; }
+    int getServerThreads() const { return serverThreads_; }
+
+    // Chế độ nhật ký (journal) cho dữ liệu sinh viên
+    void setJournalMode(bool flag) { journalMode_ = flag; }
+    bool getJournalMode() const { return journalMode_; }
+    void setJournalGroupSize(int records) { journalGroupSize_ = records; }
+    int getJournalGroupSize() const { return journalGroupSize_; }
+    void setJournalCompactThreshold(int records) { journalCompactThreshold_ = records; }
+    int getJournalCompactThreshold() const { return journalCompactThreshold_; }
+
 private:
     ConfigManager();
     ConfigManager(const ConfigManager&) = delete;
     ConfigManager& operator=(const ConfigManager&) = delete;
 
+    // Gọi khi config.json không khớp file tóm tắt (sửa tay hoặc hỏng)
+    void checkLoadedValues();
+
     int deleteTimeLimit_ = 1;
     std::string emailSuffix;
     std::string phoneRegex;
     std::string configFilename;
     bool enforceValidation_ = true;
+    unsigned long revision_ = 0;
+    std::string storageFormat_ = "json";
+    JsonOutputStyle jsonOutputStyle_ = JsonOutputStyle::Pretty;
+    int importThreads_ = 0;
+    int persistIntervalMs_ = 500;
+    int serverPort_ = 8080;
+    int serverThreads_ = 0;
+    bool journalMode_ = false;
+    int journalGroupSize_ = 64;             // Số bản ghi mỗi lần fsync
+    int journalCompactThreshold_ = 10000;   // Số bản ghi trước khi gộp vào students.json
 };
 
 #endif // CONFIG_MANAGER_HPP_
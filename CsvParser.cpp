@@ -0,0 +1,108 @@
+#include "CsvParser.hpp"
+#include "CsvScanner.hpp"
+
+CsvParser::CsvParser(RecordCallback onRecord) : onRecord_(std::move(onRecord)) {}
+
+void CsvParser::beginField() {
+    if (fieldCount_ < record_.size()) {
+        record_[fieldCount_].clear();   // Giữ lại bộ nhớ đã cấp phát
+    } else {
+        record_.emplace_back();
+    }
+    ++fieldCount_;
+}
+
+void CsvParser::endRecord() {
+    if (record_.size() > fieldCount_) {
+        record_.resize(fieldCount_);
+    }
+    ++records_;
+    onRecord_(record_);
+    fieldCount_ = 0;
+    state_ = State::LineStart;
+}
+
+void CsvParser::feed(const char* data, size_t size) {
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end) {
+        if (skipLineFeed_) {
+            skipLineFeed_ = false;
+            if (*p == '\n') {
+                ++p;
+                continue;
+            }
+        }
+        switch (state_) {
+            case State::LineStart:
+                if (*p == '\n' || *p == '\r') {
+                    // Dòng trống: bỏ qua
+                    skipLineFeed_ = (*p == '\r');
+                    ++p;
+                    break;
+                }
+                // fall through
+            case State::FieldStart:
+                beginField();
+                if (*p == '"') {
+                    state_ = State::Quoted;
+                    ++p;
+                } else {
+                    state_ = State::Unquoted;
+                }
+                break;
+            case State::Unquoted: {
+                const char* stop = csvFindFieldDelimiter(p, end);
+                record_[fieldCount_ - 1].append(p, stop);
+                p = stop;
+                if (p == end) break;
+                char c = *p++;
+                if (c == ',') {
+                    state_ = State::FieldStart;
+                } else if (c == '"') {
+                    // Dấu nháy giữa trường không có nháy: giữ nguyên như ký tự thường
+                    record_[fieldCount_ - 1].push_back(c);
+                } else {
+                    skipLineFeed_ = (c == '\r');
+                    endRecord();
+                }
+                break;
+            }
+            case State::Quoted: {
+                const char* stop = csvFindQuote(p, end);
+                record_[fieldCount_ - 1].append(p, stop);
+                p = stop;
+                if (p == end) break;
+                ++p;
+                state_ = State::QuoteInQuoted;
+                break;
+            }
+            case State::QuoteInQuoted: {
+                char c = *p;
+                if (c == '"') {
+                    record_[fieldCount_ - 1].push_back('"');
+                    state_ = State::Quoted;
+                    ++p;
+                } else if (c == ',') {
+                    state_ = State::FieldStart;
+                    ++p;
+                } else if (c == '\n' || c == '\r') {
+                    skipLineFeed_ = (c == '\r');
+                    endRecord();
+                    ++p;
+                } else {
+                    // Ký tự sau dấu nháy đóng: tiếp tục như trường không có nháy
+                    state_ = State::Unquoted;
+                }
+                break;
+            }
+        }
+    }
+}
+
+void CsvParser::finish() {
+    if (state_ != State::LineStart) {
+        endRecord();
+    }
+    skipLineFeed_ = false;
+}
@@ -0,0 +1,47 @@
+#ifndef CSV_PARSER_HPP_
+#define CSV_PARSER_HPP_
+
+#include <string>
+#include <vector>
+#include <functional>
+
+// Bộ phân tích CSV theo luồng (RFC 4180): trường có thể nằm trong dấu nháy kép,
+// chứa dấu phẩy/xuống dòng, và "" là một dấu nháy. Dữ liệu được nạp theo từng
+// khối bất kỳ qua feed(); mỗi bản ghi hoàn chỉnh được trả về qua callback.
+// Các chuỗi trong bản ghi được tái sử dụng giữa các lần gọi nên callback cần
+// sao chép nếu muốn giữ lại dữ liệu.
+class CsvParser {
+public:
+    using RecordCallback = std::function<void(const std::vector<std::string>&)>;
+
+    explicit CsvParser(RecordCallback onRecord);
+
+    // Phân tích thêm `size` byte; bản ghi có thể trải qua nhiều lần gọi
+    void feed(const char* data, size_t size);
+
+    // Kết thúc dữ liệu: trả về bản ghi cuối nếu file không kết thúc bằng xuống dòng
+    void finish();
+
+    size_t recordCount() const { return records_; }
+
+private:
+    enum class State {
+        LineStart,      // Chưa đọc ký tự nào của bản ghi hiện tại
+        FieldStart,     // Ngay sau dấu phẩy
+        Unquoted,
+        Quoted,
+        QuoteInQuoted   // Vừa gặp dấu nháy bên trong trường có nháy
+    };
+
+    void beginField();
+    void endRecord();
+
+    RecordCallback onRecord_;
+    State state_ = State::LineStart;
+    bool skipLineFeed_ = false;         // Vừa gặp '\r', bỏ qua '\n' ngay sau nếu có
+    std::vector<std::string> record_;   // Các phần tử [0, fieldCount_) là trường đang dùng
+    size_t fieldCount_ = 0;
+    size_t records_ = 0;
+};
+
+#endif // CSV_PARSER_HPP_
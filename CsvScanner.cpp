@@ -0,0 +1,188 @@
+#include "CsvScanner.hpp"
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CSV_SCANNER_X86 1
+#endif
+
+namespace {
+
+const char* findDelimiterScalar(const char* p, const char* end) {
+    while (p < end) {
+        char c = *p;
+        if (c == ',' || c == '"' || c == '\n' || c == '\r') break;
+        ++p;
+    }
+    return p;
+}
+
+const char* findQuoteScalar(const char* p, const char* end) {
+    while (p < end && *p != '"') ++p;
+    return p;
+}
+
+#ifdef CSV_SCANNER_X86
+
+__attribute__((target("sse2")))
+inline unsigned delimiterMask16(__m128i block) {
+    __m128i hit = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(',')), _mm_cmpeq_epi8(block, _mm_set1_epi8('"'))),
+        _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\r'))));
+    return static_cast<unsigned>(_mm_movemask_epi8(hit));
+}
+
+__attribute__((target("sse2")))
+inline unsigned quoteMask16(__m128i block) {
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('"'))));
+}
+
+// Gộp mặt nạ của 4 khối 16 byte thành một mặt nạ 64 bit
+template <unsigned (*Mask)(__m128i)>
+__attribute__((target("sse2")))
+const char* findSSE2(const char* p, const char* end, const char* (*tail)(const char*, const char*)) {
+    while (end - p >= 64) {
+        uint64_t m0 = Mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        uint64_t m1 = Mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)));
+        uint64_t m2 = Mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32)));
+        uint64_t m3 = Mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48)));
+        uint64_t mask = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+        if (mask != 0) return p + __builtin_ctzll(mask);
+        p += 64;
+    }
+    while (end - p >= 16) {
+        unsigned mask = Mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        if (mask != 0) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+    return tail(p, end);
+}
+
+const char* findDelimiterSSE2(const char* p, const char* end) {
+    return findSSE2<delimiterMask16>(p, end, findDelimiterScalar);
+}
+
+const char* findQuoteSSE2(const char* p, const char* end) {
+    return findSSE2<quoteMask16>(p, end, findQuoteScalar);
+}
+
+__attribute__((target("avx2")))
+inline uint32_t delimiterMask32(__m256i block) {
+    __m256i hit = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(',')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('"'))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r'))));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+}
+
+__attribute__((target("avx2")))
+inline uint32_t quoteMask32(__m256i block) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('"'))));
+}
+
+template <uint32_t (*Mask)(__m256i)>
+__attribute__((target("avx2")))
+const char* findAVX2(const char* p, const char* end, const char* (*tail)(const char*, const char*)) {
+    while (end - p >= 64) {
+        uint64_t lo = Mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        uint64_t hi = Mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)));
+        uint64_t mask = lo | (hi << 32);
+        if (mask != 0) return p + __builtin_ctzll(mask);
+        p += 64;
+    }
+    if (end - p >= 32) {
+        uint32_t mask = Mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        if (mask != 0) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return tail(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* findDelimiterAVX2(const char* p, const char* end) {
+    return findAVX2<delimiterMask32>(p, end, findDelimiterSSE2);
+}
+
+__attribute__((target("avx2")))
+const char* findQuoteAVX2(const char* p, const char* end) {
+    return findAVX2<quoteMask32>(p, end, findQuoteSSE2);
+}
+
+#endif // CSV_SCANNER_X86
+
+using FindFn = const char* (*)(const char*, const char*);
+
+struct ScanImpl {
+    CsvScanMode mode;
+    FindFn findDelimiter;
+    FindFn findQuote;
+};
+
+bool isSupported(CsvScanMode mode) {
+    switch (mode) {
+        case CsvScanMode::Scalar:
+            return true;
+#ifdef CSV_SCANNER_X86
+        case CsvScanMode::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case CsvScanMode::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+ScanImpl implFor(CsvScanMode mode) {
+    if (mode == CsvScanMode::Auto) {
+        mode = isSupported(CsvScanMode::AVX2) ? CsvScanMode::AVX2
+             : isSupported(CsvScanMode::SSE2) ? CsvScanMode::SSE2
+             : CsvScanMode::Scalar;
+    }
+    switch (mode) {
+#ifdef CSV_SCANNER_X86
+        case CsvScanMode::AVX2:
+            return {mode, findDelimiterAVX2, findQuoteAVX2};
+        case CsvScanMode::SSE2:
+            return {mode, findDelimiterSSE2, findQuoteSSE2};
+#endif
+        default:
+            return {CsvScanMode::Scalar, findDelimiterScalar, findQuoteScalar};
+    }
+}
+
+ScanImpl& activeImpl() {
+    static ScanImpl impl = implFor(CsvScanMode::Auto);
+    return impl;
+}
+
+} // namespace
+
+const char* csvFindFieldDelimiter(const char* p, const char* end) {
+    return activeImpl().findDelimiter(p, end);
+}
+
+const char* csvFindQuote(const char* p, const char* end) {
+    return activeImpl().findQuote(p, end);
+}
+
+bool setCsvScanMode(CsvScanMode mode) {
+    if (mode != CsvScanMode::Auto && !isSupported(mode)) {
+        return false;
+    }
+    activeImpl() = implFor(mode);
+    return true;
+}
+
+CsvScanMode getCsvScanMode() {
+    return activeImpl().mode;
+}
+
+const char* csvScanModeName(CsvScanMode mode) {
+    switch (mode) {
+        case CsvScanMode::Auto: return "auto";
+        case CsvScanMode::Scalar: return "scalar";
+        case CsvScanMode::SSE2: return "sse2";
+        case CsvScanMode::AVX2: return "avx2";
+    }
+    return "unknown";
+}
@@ -0,0 +1,26 @@
+#ifndef CSV_SCANNER_HPP_
+#define CSV_SCANNER_HPP_
+
+// Tìm nhanh các ký tự đặc biệt của CSV trong một vùng nhớ.
+// Trên x86 dùng SSE2/AVX2 (xét 64 byte mỗi vòng lặp), chọn lúc chạy theo CPU;
+// các nền tảng khác dùng bản vô hướng.
+
+enum class CsvScanMode {
+    Auto,       // Chọn bản nhanh nhất CPU hỗ trợ
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// Vị trí đầu tiên trong [p, end) chứa ',', '"', '\r' hoặc '\n' (end nếu không có)
+const char* csvFindFieldDelimiter(const char* p, const char* end);
+
+// Vị trí dấu nháy kép đầu tiên trong [p, end) (end nếu không có)
+const char* csvFindQuote(const char* p, const char* end);
+
+// Ép dùng một cài đặt cụ thể (dùng cho benchmark/kiểm thử); trả về false nếu CPU không hỗ trợ
+bool setCsvScanMode(CsvScanMode mode);
+CsvScanMode getCsvScanMode();
+const char* csvScanModeName(CsvScanMode mode);
+
+#endif // CSV_SCANNER_HPP_
@@ -0,0 +1,135 @@
+#include "FuzzyIndex.hpp"
+#include <algorithm>
+
+int editDistance(const std::string& a, const std::string& b) {
+    const std::string& shorter = a.size() < b.size() ? a : b;
+    const std::string& longer = a.size() < b.size() ? b : a;
+    // Chỉ giữ một hàng của bảng quy hoạch động (độ dài chuỗi ngắn hơn);
+    // MSSV và họ tên thường ngắn nên dùng bộ đệm trên stack
+    int stackRow[64];
+    std::vector<int> heapRow;
+    int* row = stackRow;
+    if (shorter.size() + 1 > 64) {
+        heapRow.resize(shorter.size() + 1);
+        row = heapRow.data();
+    }
+    for (size_t j = 0; j <= shorter.size(); ++j) {
+        row[j] = static_cast<int>(j);
+    }
+    for (size_t i = 1; i <= longer.size(); ++i) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= shorter.size(); ++j) {
+            int above = row[j];
+            int cost = longer[i - 1] == shorter[j - 1] ? 0 : 1;
+            row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + cost});
+            diagonal = above;
+        }
+    }
+    return row[shorter.size()];
+}
+
+uint32_t FuzzyIndex::addNode(const std::string& term) {
+    uint32_t index = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back({term, {}, {}});
+    termNodes_.emplace(term, index);
+    if (index == 0) {
+        return index;
+    }
+    // Đi xuống từ gốc theo khoảng cách cho tới khi gặp chỗ trống
+    uint32_t current = 0;
+    while (true) {
+        int distance = editDistance(term, nodes_[current].term);
+        auto& children = nodes_[current].children;
+        auto child = std::find_if(children.begin(), children.end(),
+                                  [distance](const std::pair<int, uint32_t>& c) { return c.first == distance; });
+        if (child == children.end()) {
+            children.emplace_back(distance, index);
+            return index;
+        }
+        current = child->second;
+    }
+}
+
+void FuzzyIndex::insert(const std::string& term, const std::string& key) {
+    auto found = termNodes_.find(term);
+    uint32_t index = found != termNodes_.end() ? found->second : addNode(term);
+    Node& node = nodes_[index];
+    if (node.keys.empty() && found != termNodes_.end()) {
+        --emptyNodes_;
+    }
+    node.keys.push_back(key);
+}
+
+void FuzzyIndex::erase(const std::string& term, const std::string& key) {
+    auto found = termNodes_.find(term);
+    if (found == termNodes_.end()) {
+        return;
+    }
+    std::vector<std::string>& keys = nodes_[found->second].keys;
+    auto it = std::find(keys.begin(), keys.end(), key);
+    if (it == keys.end()) {
+        return;
+    }
+    *it = std::move(keys.back());
+    keys.pop_back();
+    if (keys.empty() && ++emptyNodes_ > termNodes_.size() / 2) {
+        rebuild();
+    }
+}
+
+void FuzzyIndex::clear() {
+    nodes_.clear();
+    termNodes_.clear();
+    emptyNodes_ = 0;
+}
+
+void FuzzyIndex::rebuild() {
+    std::vector<Node> old;
+    old.swap(nodes_);
+    termNodes_.clear();
+    emptyNodes_ = 0;
+    for (Node& node : old) {
+        if (!node.keys.empty()) {
+            nodes_[addNode(node.term)].keys = std::move(node.keys);
+        }
+    }
+}
+
+std::vector<FuzzyIndex::Match> FuzzyIndex::search(const std::string& query, size_t k, int maxDistance) const {
+    std::vector<Match> best; // Giữ tăng dần theo khoảng cách, tối đa k phần tử
+    if (nodes_.empty() || k == 0) {
+        return best;
+    }
+    int tau = maxDistance;
+    std::vector<uint32_t> pending = {0};
+    while (!pending.empty()) {
+        const Node& node = nodes_[pending.back()];
+        pending.pop_back();
+        int distance = editDistance(query, node.term);
+        if (distance <= tau) {
+            for (const std::string& key : node.keys) {
+                Match match{key, distance};
+                auto pos = std::upper_bound(best.begin(), best.end(), match,
+                                            [](const Match& a, const Match& b) { return a.distance < b.distance; });
+                best.insert(pos, std::move(match));
+                if (best.size() > k) {
+                    best.pop_back();
+                }
+            }
+            // Đủ k kết quả: chỉ còn tìm những khóa gần hơn kết quả xa nhất hiện có
+            if (best.size() == k) {
+                tau = std::min(tau, best.back().distance - 1);
+                if (tau < 0) {
+                    break;
+                }
+            }
+        }
+        for (const auto& child : node.children) {
+            if (child.first >= distance - tau && child.first <= distance + tau) {
+                pending.push_back(child.second);
+            }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,48 @@
+#ifndef FUZZY_INDEX_HPP_
+#define FUZZY_INDEX_HPP_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unordered_map>
+
+// Khoảng cách Levenshtein (số phép chèn/xóa/thay ký tự) giữa hai chuỗi byte
+int editDistance(const std::string& a, const std::string& b);
+
+// BK-tree cho tìm kiếm gần đúng theo khoảng cách chỉnh sửa.
+// Mỗi nút là một chuỗi (term) kèm danh sách khóa (MSSV) có chuỗi đó; khi tìm với bán kính
+// `tau` chỉ cần xét các nhánh con có khoảng cách trong [d - tau, d + tau].
+// Xóa chỉ gỡ khóa khỏi nút; cây được dựng lại khi số nút rỗng vượt số nút còn dùng.
+class FuzzyIndex {
+public:
+    struct Match {
+        std::string key;
+        int distance;
+    };
+
+    void insert(const std::string& term, const std::string& key);
+    void erase(const std::string& term, const std::string& key);
+    void clear();
+
+    // Tối đa `k` khóa gần `query` nhất với khoảng cách <= `maxDistance`, tăng dần theo khoảng cách
+    std::vector<Match> search(const std::string& query, size_t k, int maxDistance) const;
+
+    size_t termCount() const { return termNodes_.size() - emptyNodes_; }
+
+private:
+    struct Node {
+        std::string term;
+        std::vector<std::string> keys;
+        std::vector<std::pair<int, uint32_t>> children; // (khoảng cách tới nút này, chỉ số nút con)
+    };
+
+    uint32_t addNode(const std::string& term);
+    void rebuild();
+
+    std::vector<Node> nodes_;
+    std::unordered_map<std::string, uint32_t> termNodes_; // term -> chỉ số nút
+    size_t emptyNodes_ = 0;
+};
+
+#endif // FUZZY_INDEX_HPP_
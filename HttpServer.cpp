@@ -0,0 +1,445 @@
+#include "HttpServer.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Giải mã %XX (và '+' thành khoảng trắng nếu `plusIsSpace`, dùng cho query)
+std::string urlDecode(const std::string& text, bool plusIsSpace) {
+    std::string decoded;
+    decoded.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '%' && i + 2 < text.size() && hexValue(text[i + 1]) >= 0 && hexValue(text[i + 2]) >= 0) {
+            decoded.push_back(static_cast<char>(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2])));
+            i += 2;
+        } else if (text[i] == '+' && plusIsSpace) {
+            decoded.push_back(' ');
+        } else {
+            decoded.push_back(text[i]);
+        }
+    }
+    return decoded;
+}
+
+void parseQuery(const std::string& text, std::map<std::string, std::string>& query) {
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        size_t end = text.find('&', pos);
+        if (end == std::string::npos) end = text.size();
+        std::string pair = text.substr(pos, end - pos);
+        if (!pair.empty()) {
+            size_t equals = pair.find('=');
+            if (equals == std::string::npos) {
+                query[urlDecode(pair, true)] = "";
+            } else {
+                query[urlDecode(pair.substr(0, equals), true)] = urlDecode(pair.substr(equals + 1), true);
+            }
+        }
+        pos = end + 1;
+    }
+}
+
+HttpResponse errorResponse(int status, const std::string& message) {
+    HttpResponse response;
+    response.status = status;
+    response.body = "{\"error\":\"" + message + "\"}";
+    return response;
+}
+
+} // namespace
+
+HttpServer::HttpServer(Handler handler, size_t threads)
+    : handler_(std::move(handler)), pool_(std::make_unique<ThreadPool>(threads)) {}
+
+HttpServer::~HttpServer() {
+    pool_.reset(); // Chờ các yêu cầu đang chạy xong: chúng còn ghi vào wakeFd_
+    for (auto& entry : connections_) {
+        ::close(entry.second.fd);
+    }
+    if (listenFd_ >= 0) ::close(listenFd_);
+    if (epollFd_ >= 0) ::close(epollFd_);
+    if (wakeFd_ >= 0) ::close(wakeFd_);
+}
+
+const char* HttpServer::reasonPhrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 422: return "Unprocessable Entity";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+bool HttpServer::listen(const std::string& host, uint16_t port) {
+    auto fail = [&](const char* step) {
+        Logger::getInstance().log(std::string("HTTP server: ") + step + " failed: " + std::strerror(errno),
+                                  LogLevel::Error);
+        return false;
+    };
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+        errno = EINVAL;
+        return fail("address");
+    }
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) return fail("socket");
+    int on = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) return fail("bind");
+    if (::listen(listenFd_, SOMAXCONN) != 0) return fail("listen");
+    socklen_t length = sizeof(address);
+    ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+
+    epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) return fail("epoll_create1");
+    wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) return fail("eventfd");
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = kListenId;
+    ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &event);
+    event.data.u64 = kWakeId;
+    ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+    Logger::getInstance().log("HTTP server listening on " + host + ":" + std::to_string(port_));
+    return true;
+}
+
+void HttpServer::stop() {
+    stopping_.store(true);
+    if (wakeFd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd_, &one, sizeof(one)); // Chỉ dùng hàm an toàn trong signal handler
+        (void)ignored;
+    }
+}
+
+void HttpServer::run() {
+    std::vector<epoll_event> events(256);
+    auto lastSweep = std::chrono::steady_clock::now();
+    while (!stopping_.load()) {
+        int count = ::epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), 1000);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            Logger::getInstance().log(std::string("HTTP server: epoll_wait failed: ") + std::strerror(errno),
+                                      LogLevel::Error);
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            uint64_t id = events[i].data.u64;
+            if (id == kListenId) {
+                acceptConnections();
+                continue;
+            }
+            if (id == kWakeId) {
+                uint64_t value;
+                while (::read(wakeFd_, &value, sizeof(value)) > 0) {}
+                collectCompletions();
+                continue;
+            }
+            auto entry = connections_.find(id);
+            if (entry == connections_.end()) {
+                continue; // Đã đóng bởi một sự kiện trước trong cùng lượt
+            }
+            Connection& connection = entry->second;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeConnection(id);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                flushOutput(id, connection);
+                if (connections_.count(id) == 0) continue;
+            }
+            if (events[i].events & EPOLLIN) {
+                readFrom(id, connection);
+            }
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSweep >= std::chrono::seconds(1)) {
+            closeIdleConnections();
+            lastSweep = now;
+        }
+    }
+    std::vector<uint64_t> ids;
+    for (const auto& entry : connections_) {
+        ids.push_back(entry.first);
+    }
+    for (uint64_t id : ids) {
+        closeConnection(id);
+    }
+    Logger::getInstance().log("HTTP server stopped.");
+}
+
+void HttpServer::acceptConnections() {
+    for (;;) {
+        int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                Logger::getInstance().log(std::string("HTTP server: accept failed: ") + std::strerror(errno),
+                                          LogLevel::Error);
+            }
+            return;
+        }
+        int on = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // Phản hồi nhỏ, không chờ gom gói
+        uint64_t id = nextId_++;
+        Connection& connection = connections_[id];
+        connection.fd = fd;
+        connection.lastActive = std::chrono::steady_clock::now();
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = id;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+void HttpServer::readFrom(uint64_t id, Connection& connection) {
+    char buffer[64 * 1024];
+    for (;;) {
+        ssize_t received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.in.append(buffer, static_cast<size_t>(received));
+            if (connection.in.size() > kMaxHeaderBytes + kMaxBodyBytes) {
+                closeConnection(id); // Gửi dồn quá nhiều yêu cầu khi chưa đọc phản hồi
+                return;
+            }
+            continue;
+        }
+        if (received < 0 && errno == EINTR) continue;
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        closeConnection(id); // Client đã đóng (0) hoặc lỗi
+        return;
+    }
+    connection.lastActive = std::chrono::steady_clock::now();
+    if (!connection.busy && connection.out.empty()) {
+        dispatchNext(id, connection);
+    }
+}
+
+void HttpServer::dispatchNext(uint64_t id, Connection& connection) {
+    size_t headerEnd = connection.in.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) {
+        if (connection.in.size() > kMaxHeaderBytes) {
+            queueResponse(id, connection, errorResponse(431, "Header quá lớn"), false);
+            return;
+        }
+        return; // Chờ thêm dữ liệu
+    }
+    if (headerEnd > kMaxHeaderBytes) {
+        queueResponse(id, connection, errorResponse(431, "Header quá lớn"), false);
+        return;
+    }
+
+    HttpRequest request;
+    std::string version;
+    size_t lineEnd = connection.in.find("\r\n");
+    {
+        std::string line = connection.in.substr(0, lineEnd);
+        size_t first = line.find(' ');
+        size_t second = first == std::string::npos ? std::string::npos : line.find(' ', first + 1);
+        if (second == std::string::npos) {
+            queueResponse(id, connection, errorResponse(400, "Dòng yêu cầu không hợp lệ"), false);
+            return;
+        }
+        request.method = line.substr(0, first);
+        std::string target = line.substr(first + 1, second - first - 1);
+        version = line.substr(second + 1);
+        size_t question = target.find('?');
+        request.path = urlDecode(target.substr(0, question), false);
+        if (question != std::string::npos) {
+            parseQuery(target.substr(question + 1), request.query);
+        }
+    }
+    if (version != "HTTP/1.1" && version != "HTTP/1.0") {
+        queueResponse(id, connection, errorResponse(400, "Phiên bản HTTP không hỗ trợ"), false);
+        return;
+    }
+    size_t pos = lineEnd + 2;
+    while (pos < headerEnd) {
+        size_t end = connection.in.find("\r\n", pos);
+        std::string line = connection.in.substr(pos, end - pos);
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            queueResponse(id, connection, errorResponse(400, "Header không hợp lệ"), false);
+            return;
+        }
+        request.headers[toLower(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+        pos = end + 2;
+    }
+
+    std::string connectionHeader = toLower(request.headers["connection"]);
+    bool keepAlive = version == "HTTP/1.1" ? connectionHeader != "close" : connectionHeader == "keep-alive";
+    if (request.headers.count("transfer-encoding") > 0) {
+        queueResponse(id, connection, errorResponse(501, "Không hỗ trợ Transfer-Encoding"), false);
+        return;
+    }
+    size_t bodyLength = 0;
+    auto length = request.headers.find("content-length");
+    if (length != request.headers.end()) {
+        const std::string& text = length->second;
+        if (text.empty() || text.size() > 9 || text.find_first_not_of("0123456789") != std::string::npos) {
+            queueResponse(id, connection, errorResponse(400, "Content-Length không hợp lệ"), false);
+            return;
+        }
+        bodyLength = std::stoul(text);
+        if (bodyLength > kMaxBodyBytes) {
+            queueResponse(id, connection, errorResponse(413, "Nội dung quá lớn"), false);
+            return;
+        }
+    }
+    size_t total = headerEnd + 4 + bodyLength;
+    if (connection.in.size() < total) {
+        return; // Chờ phần còn lại của body
+    }
+    request.body = connection.in.substr(headerEnd + 4, bodyLength);
+    connection.in.erase(0, total);
+
+    connection.busy = true;
+    pool_->submit([this, id, keepAlive, request = std::move(request)] {
+        HttpResponse response;
+        try {
+            response = handler_(request);
+        } catch (const std::exception& ex) {
+            Logger::getInstance().log(std::string("HTTP handler failed: ") + ex.what(), LogLevel::Error);
+            response = errorResponse(500, "Lỗi máy chủ");
+        }
+        {
+            std::lock_guard<std::mutex> lock(completionsMutex_);
+            completions_.push_back({id, std::move(response), keepAlive});
+        }
+        uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd_, &one, sizeof(one));
+        (void)ignored;
+    });
+}
+
+void HttpServer::collectCompletions() {
+    std::vector<Completion> done;
+    {
+        std::lock_guard<std::mutex> lock(completionsMutex_);
+        done.swap(completions_);
+    }
+    for (Completion& completion : done) {
+        auto entry = connections_.find(completion.id);
+        if (entry == connections_.end()) {
+            continue; // Client đã đóng kết nối trong lúc xử lý
+        }
+        entry->second.busy = false;
+        queueResponse(completion.id, entry->second, completion.response, completion.keepAlive);
+    }
+}
+
+void HttpServer::queueResponse(uint64_t id, Connection& connection, const HttpResponse& response, bool keepAlive) {
+    connection.keepAlive = keepAlive;
+    connection.out += "HTTP/1.1 " + std::to_string(response.status) + " " + reasonPhrase(response.status) + "\r\n";
+    connection.out += "Content-Type: " + response.contentType + "\r\n";
+    connection.out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+    connection.out += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    connection.out += response.body;
+    flushOutput(id, connection);
+}
+
+void HttpServer::flushOutput(uint64_t id, Connection& connection) {
+    while (connection.written < connection.out.size()) {
+        ssize_t sent = ::send(connection.fd, connection.out.data() + connection.written,
+                              connection.out.size() - connection.written, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                updateInterest(id, connection, true); // Ghi tiếp khi socket sẵn sàng
+                return;
+            }
+            closeConnection(id);
+            return;
+        }
+        connection.written += static_cast<size_t>(sent);
+    }
+    connection.out.clear();
+    connection.written = 0;
+    connection.lastActive = std::chrono::steady_clock::now();
+    updateInterest(id, connection, false);
+    if (!connection.keepAlive) {
+        closeConnection(id);
+        return;
+    }
+    dispatchNext(id, connection); // Yêu cầu kế tiếp client đã gửi (nếu có)
+}
+
+void HttpServer::updateInterest(uint64_t id, Connection& connection, bool writable) {
+    if (connection.writable == writable) {
+        return;
+    }
+    connection.writable = writable;
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP | (writable ? EPOLLOUT : 0u);
+    event.data.u64 = id;
+    ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+void HttpServer::closeIdleConnections() {
+    auto deadline = std::chrono::steady_clock::now() - kIdleTimeout;
+    std::vector<uint64_t> idle;
+    for (const auto& entry : connections_) {
+        if (!entry.second.busy && entry.second.out.empty() && entry.second.lastActive < deadline) {
+            idle.push_back(entry.first);
+        }
+    }
+    for (uint64_t id : idle) {
+        closeConnection(id);
+    }
+}
+
+void HttpServer::closeConnection(uint64_t id) {
+    auto entry = connections_.find(id);
+    if (entry == connections_.end()) {
+        return;
+    }
+    ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, entry->second.fd, nullptr);
+    ::close(entry->second.fd);
+    connections_.erase(entry);
+}
@@ -0,0 +1,111 @@
+#ifndef HTTP_SERVER_HPP_
+#define HTTP_SERVER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ThreadPool.hpp"
+
+struct HttpRequest {
+    std::string method;
+    std::string path;                           // Đã giải mã %XX, không gồm query
+    std::map<std::string, std::string> query;   // Tham số query đã giải mã
+    std::map<std::string, std::string> headers; // Tên header viết thường
+    std::string body;
+};
+
+struct HttpResponse {
+    int status = 200;
+    std::string contentType = "application/json; charset=utf-8";
+    std::string body;
+};
+
+// Máy chủ HTTP/1.1 tối giản: một luồng chạy vòng lặp epoll với socket không chặn (nhận kết
+// nối, đọc và tách yêu cầu, ghi phản hồi), còn `handler` chạy trên ThreadPool nên một yêu cầu
+// chậm không chặn các kết nối khác. Kết nối được giữ lại (keep-alive) theo quy tắc của
+// HTTP/1.1; mỗi kết nối xử lý lần lượt từng yêu cầu (kể cả khi client gửi liên tiếp).
+// Không hỗ trợ Transfer-Encoding: chunked ở yêu cầu (trả 501).
+class HttpServer {
+public:
+    using Handler = std::function<HttpResponse(const HttpRequest&)>;
+
+    // `handler` được gọi đồng thời từ nhiều luồng. 0 luồng: dùng số lõi của máy
+    explicit HttpServer(Handler handler, size_t threads = 0);
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    // Mở cổng lắng nghe trên `host` (địa chỉ IPv4); port 0: hệ điều hành tự chọn.
+    // Trả về false (và ghi log) nếu lỗi.
+    bool listen(const std::string& host, uint16_t port);
+    uint16_t port() const { return port_; }
+
+    // Chạy vòng lặp sự kiện trên luồng gọi hàm cho đến khi stop()
+    void run();
+
+    // Dừng run(); gọi được từ luồng khác hoặc từ signal handler
+    void stop();
+
+    static const char* reasonPhrase(int status);
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::string in;       // Dữ liệu đã nhận, chưa được tách thành yêu cầu
+        std::string out;      // Phản hồi đang chờ ghi
+        size_t written = 0;   // Số byte của `out` đã ghi
+        bool busy = false;    // Có yêu cầu đang chạy trên ThreadPool
+        bool keepAlive = true;
+        bool writable = false; // Đang đăng ký EPOLLOUT
+        std::chrono::steady_clock::time_point lastActive;
+    };
+
+    void acceptConnections();
+    void readFrom(uint64_t id, Connection& connection);
+    // Tách yêu cầu kế tiếp trong `in` (nếu đã nhận đủ) và giao cho ThreadPool; yêu cầu sai
+    // được trả lỗi ngay và kết nối bị đóng
+    void dispatchNext(uint64_t id, Connection& connection);
+    void queueResponse(uint64_t id, Connection& connection, const HttpResponse& response, bool keepAlive);
+    void flushOutput(uint64_t id, Connection& connection);
+    void collectCompletions();
+    void closeIdleConnections();
+    void closeConnection(uint64_t id);
+    void updateInterest(uint64_t id, Connection& connection, bool writable);
+
+    static constexpr size_t kMaxHeaderBytes = 16 * 1024;
+    static constexpr size_t kMaxBodyBytes = 1 << 20;
+    static constexpr std::chrono::seconds kIdleTimeout{60};
+    static constexpr uint64_t kListenId = 0;
+    static constexpr uint64_t kWakeId = 1;
+
+    Handler handler_;
+    int listenFd_ = -1;
+    int epollFd_ = -1;
+    int wakeFd_ = -1; // eventfd: có phản hồi mới hoặc stop()
+    uint16_t port_ = 0;
+    std::atomic<bool> stopping_{false};
+    uint64_t nextId_ = 2;
+    std::unordered_map<uint64_t, Connection> connections_; // Chỉ luồng chạy run() dùng
+
+    // Phản hồi do luồng xử lý gửi về luồng sự kiện
+    struct Completion {
+        uint64_t id;
+        HttpResponse response;
+        bool keepAlive;
+    };
+    std::mutex completionsMutex_;
+    std::vector<Completion> completions_;
+
+    std::unique_ptr<ThreadPool> pool_;
+};
+
+#endif // HTTP_SERVER_HPP_
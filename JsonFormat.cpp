@@ -0,0 +1,57 @@
+#include "JsonFormat.hpp"
+#include <iterator>
+#include <sstream>
+
+bool parseJsonOutputStyle(const std::string& name, JsonOutputStyle& style) {
+    if (name == "pretty") {
+        style = JsonOutputStyle::Pretty;
+    } else if (name == "compact") {
+        style = JsonOutputStyle::Compact;
+    } else if (name == "lines") {
+        style = JsonOutputStyle::Lines;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string jsonOutputStyleName(JsonOutputStyle style) {
+    switch (style) {
+        case JsonOutputStyle::Compact: return "compact";
+        case JsonOutputStyle::Lines: return "lines";
+        default: return "pretty";
+    }
+}
+
+std::string dumpJson(const json& j, JsonOutputStyle style) {
+    if (style == JsonOutputStyle::Pretty) {
+        return j.dump(4) + "\n";
+    }
+    if (style == JsonOutputStyle::Compact || !j.is_array()) {
+        return j.dump() + "\n";
+    }
+    std::string out;
+    for (const auto& item : j) {
+        out += item.dump();
+        out += '\n';
+    }
+    return out;
+}
+
+json parseJsonRecords(std::istream& in) {
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    json document = json::parse(content, nullptr, false);
+    if (!document.is_discarded()) {
+        return document.is_array() ? document : json::array({document});
+    }
+    // Không phải một giá trị JSON duy nhất: đọc từng dòng (JSON Lines), bỏ qua dòng trống
+    json records = json::array();
+    std::istringstream lines(content);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.find_first_not_of(" \t\r") != std::string::npos) {
+            records.push_back(json::parse(line));
+        }
+    }
+    return records;
+}
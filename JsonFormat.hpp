@@ -0,0 +1,30 @@
+#ifndef JSON_FORMAT_HPP_
+#define JSON_FORMAT_HPP_
+
+#include <istream>
+#include <string>
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+// Kiểu ghi file JSON (khóa "jsonOutputStyle" trong config.json)
+enum class JsonOutputStyle {
+    Pretty,  // Thụt lề 4 khoảng trắng (mặc định)
+    Compact, // Cả tài liệu trên một dòng, không có khoảng trắng thừa
+    Lines    // JSON Lines: mỗi phần tử của mảng gốc trên một dòng, không có "[" "]";
+             // tài liệu không phải mảng (config, quy luật tình trạng) được ghi như Compact
+};
+
+// "pretty", "compact", "lines"; tên không hợp lệ trả về false
+bool parseJsonOutputStyle(const std::string& name, JsonOutputStyle& style);
+std::string jsonOutputStyleName(JsonOutputStyle style);
+
+// Nội dung file của `j` theo kiểu `style`, kết thúc bằng một dấu xuống dòng
+std::string dumpJson(const json& j, JsonOutputStyle style);
+
+// Đọc một file dạng danh sách do dumpJson ghi, ở bất kỳ kiểu nào, và luôn trả về mảng:
+// một mảng JSON được trả về nguyên vẹn, một giá trị đơn lẻ thành mảng một phần tử, còn
+// nội dung nhiều giá trị thì được đọc như JSON Lines. Ném json::parse_error nếu sai cú pháp.
+json parseJsonRecords(std::istream& in);
+
+#endif // JSON_FORMAT_HPP_
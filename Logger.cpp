@@ -1,25 +1,86 @@
+
 #include "Logger.hpp"
+#include <ctime>
 
 std::string getCurrentTimestamp() {
     auto now = std::chrono::system_clock::now();
     auto time_now = std::chrono::system_clock::to_time_t(now);
     std::tm local_tm;
     localtime_r(&time_now, &local_tm); // Use localtime_r on Linux
-    std::stringstream ss;
-    ss << std::put_time(&local_tm, "%Y-%m-%d %H:%M:%S");
-    return ss.str();
+    char buffer[32];
+    size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local_tm);
+    return std::string(buffer, n);
 }
 
- void Logger::log(const std::string& message) {
-    std::ofstream logFile;
-    logFile.open("student_management.log", std::ios::app);
-    if (logFile.is_open()) {
-        logFile << getCurrentTimestamp() << ": " << message << std::endl;
-        logFile.close();
-    }
-    else {
+Logger::Logger() : ring_(kCapacity) {
+    file_.open("student_management.log", std::ios::app);
+    if (!file_.is_open()) {
         std::cerr << "Error opening log file.\n";
     }
+    writer_ = std::thread(&Logger::writerLoop, this);
 }
 
+// Flush-on-exit: luồng ghi xả hết hàng đợi trước khi kết thúc
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    notEmpty_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
 
+void Logger::log(const std::string& message, LogLevel level) {
+    std::string line = getCurrentTimestamp() + ": " + (level == LogLevel::Error ? "[ERROR] " : "") + message + "\n";
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return count_ < kCapacity; });
+        ring_[(head_ + count_) % kCapacity] = std::move(line);
+        ++count_;
+        ++enqueued_;
+    }
+    notEmpty_.notify_one();
+    if (level == LogLevel::Error) {
+        flush();
+    }
+}
+
+void Logger::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    unsigned long long target = enqueued_;
+    notEmpty_.notify_one();
+    drained_.wait(lock, [this, target] { return written_ >= target || !writer_.joinable(); });
+}
+
+void Logger::writerLoop() {
+    std::string batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        notEmpty_.wait(lock, [this] { return count_ > 0 || stopping_; });
+        if (count_ == 0 && stopping_) {
+            break;
+        }
+        // Lấy toàn bộ các dòng đang chờ rồi ghi ngoài vùng khóa
+        size_t taken = count_;
+        batch.clear();
+        for (size_t i = 0; i < taken; ++i) {
+            batch += ring_[(head_ + i) % kCapacity];
+            ring_[(head_ + i) % kCapacity].clear();
+        }
+        head_ = (head_ + taken) % kCapacity;
+        count_ = 0;
+        lock.unlock();
+        notFull_.notify_all();
+
+        if (file_.is_open()) {
+            file_.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+            file_.flush();
+        }
+
+        lock.lock();
+        written_ += taken;
+        drained_.notify_all();
+    }
+}
@@ -7,7 +7,18 @@
 #include <iomanip>
 #include <fstream>
 #include <iostream>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
+enum class LogLevel {
+    Info,
+    Error   // Ghi xuống đĩa ngay (flush-on-error)
+};
+
+// Logger ghi bất đồng bộ: log() chỉ đưa dòng vào hàng đợi vòng có giới hạn,
+// một luồng nền gom nhiều dòng và ghi một lần vào student_management.log.
 class Logger {
 public:
     static Logger& getInstance() {
@@ -15,13 +26,34 @@ public:
         return instance;
     }
 
-    void log(const std::string& message);
+    void log(const std::string& message, LogLevel level = LogLevel::Info);
+
+    // Chờ đến khi mọi dòng đã đưa vào hàng đợi được ghi và flush xuống file
+    void flush();
+
+    ~Logger();
 
 private:
-    Logger() {}
+    Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
+
+    void writerLoop();
+
+    static const size_t kCapacity = 4096;     // Số dòng tối đa trong hàng đợi
+
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::condition_variable drained_;
+    std::vector<std::string> ring_;
+    size_t head_ = 0;                         // Vị trí dòng cũ nhất
+    size_t count_ = 0;                        // Số dòng đang chờ ghi
+    unsigned long long enqueued_ = 0;
+    unsigned long long written_ = 0;
+    bool stopping_ = false;
+    std::ofstream file_;
+    std::thread writer_;
 };
 
 #endif // LOGGER_HPP_
-
@@ -0,0 +1,264 @@
+#include "NameSearchIndex.hpp"
+#include <algorithm>
+
+namespace {
+
+// Chữ cái gốc (không dấu, chữ thường) của U+00C0..U+024F và U+1E00..U+1EFF; '.' nếu không có.
+// Sinh từ phân rã NFD của Unicode, thêm Đ/đ -> d.
+const char kLatin1AndExtended[] =
+    "aaaaaa.ceeeeiiii.nooooo..uuuuy..aaaaaa.ceeeeiiii.nooooo..uuuuy.y"
+    "aaaaaaccccccccddddeeeeeeeeeegggggggghh..iiiiiiiii...jjkk.llllll."
+    "...nnnnnn...oooooo..rrrrrrsssssssstttt..uuuuuuuuuuuuwwyyyzzzzzz."
+    "................................oo.............uu..............."
+    ".............aaiioouuuuuuuuuu.aaaa....ggkkoooo..j...gg..nnaa...."
+    "aaaaeeeeiiiioooorrrruuuusstt..hh......aaeeooooooooyy............"
+    "................";
+
+const char kLatinExtendedAdditional[] =
+    "aabbbbbbccddddddddddeeeeeeeeeeffgghhhhhhhhhhiiiikkkkkkllllllllmm"
+    "mmmmnnnnnnnnoooooooopppprrrrrrrrssssssssssttttttttuuuuuuuuuuvvvv"
+    "wwwwwwwwwwxxxxyyzzzzzzhtwy......aaaaaaaaaaaaaaaaaaaaaaaaeeeeeeee"
+    "eeeeeeeeiiiioooooooooooooooooooooooouuuuuuuuuuuuuuyyyyyyyy......";
+
+// Giải mã một ký tự UTF-8 tại `pos`; trả về số byte đã đọc (1 nếu byte không hợp lệ)
+size_t decodeUtf8(std::string_view s, size_t pos, uint32_t& cp) {
+    unsigned char c = static_cast<unsigned char>(s[pos]);
+    size_t length = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+    if (length == 0 || pos + length > s.size()) {
+        cp = c;
+        return 1;
+    }
+    cp = length == 1 ? c : length == 2 ? (c & 0x1F) : length == 3 ? (c & 0x0F) : (c & 0x07);
+    for (size_t i = 1; i < length; ++i) {
+        unsigned char next = static_cast<unsigned char>(s[pos + i]);
+        if ((next & 0xC0) != 0x80) {
+            cp = c;
+            return 1;
+        }
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    return length;
+}
+
+// Chữ cái gốc của `cp`, 0 nếu không thuộc bảng
+char baseLetter(uint32_t cp) {
+    char base = 0;
+    if (cp >= 0xC0 && cp < 0xC0 + sizeof(kLatin1AndExtended) - 1) {
+        base = kLatin1AndExtended[cp - 0xC0];
+    } else if (cp >= 0x1E00 && cp < 0x1E00 + sizeof(kLatinExtendedAdditional) - 1) {
+        base = kLatinExtendedAdditional[cp - 0x1E00];
+    }
+    return base == '.' ? 0 : base;
+}
+
+uint32_t packTrigram(const char* p) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(p[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(p[1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(p[2]));
+}
+
+} // namespace
+
+std::string foldName(std::string_view utf8) {
+    std::string folded;
+    folded.reserve(utf8.size());
+    bool pendingSpace = false;
+    for (size_t pos = 0; pos < utf8.size();) {
+        uint32_t cp;
+        size_t length = decodeUtf8(utf8, pos, cp);
+        char letter = 0;
+        if (cp < 0x80) {
+            char c = static_cast<char>(cp);
+            if (c >= 'A' && c <= 'Z') {
+                letter = static_cast<char>(c - 'A' + 'a');
+            } else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+                letter = c;
+            } else {
+                pendingSpace = true; // Khoảng trắng và dấu câu phân tách từ
+            }
+        } else if (cp >= 0x300 && cp <= 0x36F) {
+            // Dấu tổ hợp (NFD): bỏ qua
+        } else {
+            letter = baseLetter(cp);
+        }
+        if (letter != 0 || (cp >= 0x80 && !(cp >= 0x300 && cp <= 0x36F))) {
+            if (pendingSpace && !folded.empty()) {
+                folded += ' ';
+            }
+            pendingSpace = false;
+            if (letter != 0) {
+                folded += letter;
+            } else {
+                folded.append(utf8, pos, length); // Chữ ngoài bảng Latin: giữ nguyên
+            }
+        }
+        pos += length;
+    }
+    return folded;
+}
+
+std::vector<uint32_t> NameSearchIndex::trigramsOf(const std::string& text) {
+    std::vector<uint32_t> trigrams;
+    if (text.size() < 3) {
+        return trigrams;
+    }
+    trigrams.reserve(text.size() - 2);
+    for (size_t i = 0; i + 3 <= text.size(); ++i) {
+        trigrams.push_back(packTrigram(text.data() + i));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+void NameSearchIndex::insert(size_t slot, std::string_view name) {
+    if (slot >= folded_.size()) {
+        folded_.resize(slot + 1);
+    }
+    folded_[slot] = " " + foldName(name);
+    uint32_t value = static_cast<uint32_t>(slot);
+    for (uint32_t trigram : trigramsOf(folded_[slot])) {
+        Posting& posting = postings_[trigram];
+        if (posting.empty() || posting.back() < value) {
+            posting.push_back(value);
+        } else {
+            posting.insert(std::lower_bound(posting.begin(), posting.end(), value), value);
+        }
+    }
+}
+
+void NameSearchIndex::erase(size_t slot) {
+    if (slot >= folded_.size()) {
+        return;
+    }
+    uint32_t value = static_cast<uint32_t>(slot);
+    for (uint32_t trigram : trigramsOf(folded_[slot])) {
+        auto found = postings_.find(trigram);
+        Posting& posting = found->second;
+        posting.erase(std::lower_bound(posting.begin(), posting.end(), value));
+        if (posting.empty()) {
+            postings_.erase(found);
+        }
+    }
+    folded_[slot].clear();
+}
+
+void NameSearchIndex::relocate(size_t from, size_t to) {
+    if (to >= folded_.size()) {
+        folded_.resize(to + 1);
+    }
+    uint32_t fromValue = static_cast<uint32_t>(from);
+    uint32_t toValue = static_cast<uint32_t>(to);
+    for (uint32_t trigram : trigramsOf(folded_[from])) {
+        Posting& posting = postings_[trigram];
+        auto source = std::lower_bound(posting.begin(), posting.end(), fromValue);
+        auto target = std::lower_bound(posting.begin(), posting.end(), toValue);
+        // Dời phần tử về đúng thứ tự bằng một lần rotate thay vì erase + insert
+        if (target <= source) {
+            std::rotate(target, source, source + 1);
+        } else {
+            std::rotate(source, source + 1, target);
+            --target;
+        }
+        *target = toValue;
+    }
+    folded_[to] = std::move(folded_[from]);
+    folded_[from].clear();
+}
+
+void NameSearchIndex::clear() {
+    folded_.clear();
+    postings_.clear();
+}
+
+bool NameSearchIndex::matches(size_t slot, const std::string& foldedQuery, NameMatchMode mode) const {
+    if (slot >= folded_.size() || folded_[slot].empty()) {
+        return false;
+    }
+    if (mode == NameMatchMode::Prefix) {
+        // folded_ luôn bắt đầu bằng khoảng trắng nên đầu từ nào cũng đứng sau một khoảng trắng
+        const std::string& name = folded_[slot];
+        for (size_t pos = name.find(' '); pos != std::string::npos; pos = name.find(' ', pos + 1)) {
+            if (name.compare(pos + 1, foldedQuery.size(), foldedQuery) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return folded_[slot].find(foldedQuery, 1) != std::string::npos;
+}
+
+namespace {
+
+// Tiến `pos` tới phần tử đầu tiên >= `value`: nhảy theo bước gấp đôi rồi tìm nhị phân
+size_t gallop(const std::vector<uint32_t>& posting, size_t pos, uint32_t value) {
+    size_t step = 1;
+    size_t high = pos;
+    while (high < posting.size() && posting[high] < value) {
+        pos = high + 1;
+        high += step;
+        step <<= 1;
+    }
+    high = std::min(high, posting.size());
+    return static_cast<size_t>(std::lower_bound(posting.begin() + pos, posting.begin() + high, value) -
+                               posting.begin());
+}
+
+} // namespace
+
+std::vector<size_t> NameSearchIndex::search(const std::string& query, NameMatchMode mode, size_t limit) const {
+    std::vector<size_t> results;
+    std::string foldedQuery = foldName(query);
+    if (foldedQuery.empty() || limit == 0) {
+        return results;
+    }
+    // Trigram của truy vấn; với tìm đầu từ thì khoảng trắng phía trước cũng thuộc truy vấn
+    std::vector<uint32_t> trigrams = trigramsOf(mode == NameMatchMode::Prefix ? " " + foldedQuery : foldedQuery);
+
+    if (trigrams.empty()) {
+        // Truy vấn quá ngắn để có trigram: duyệt toàn bộ họ tên đã chuẩn hóa
+        for (size_t slot = 0; slot < folded_.size() && results.size() < limit; ++slot) {
+            if (matches(slot, foldedQuery, mode)) {
+                results.push_back(slot);
+            }
+        }
+        return results;
+    }
+
+    std::vector<const Posting*> lists;
+    lists.reserve(trigrams.size());
+    for (uint32_t trigram : trigrams) {
+        auto found = postings_.find(trigram);
+        if (found == postings_.end()) {
+            return results; // Có trigram không xuất hiện ở tên nào
+        }
+        lists.push_back(&found->second);
+    }
+    std::sort(lists.begin(), lists.end(), [](const Posting* a, const Posting* b) {
+        return a->size() < b->size();
+    });
+
+    // Duyệt danh sách ngắn nhất, giữ con trỏ tăng dần trên các danh sách còn lại.
+    // Giao trigram chưa đảm bảo đúng thứ tự ký tự nên vẫn kiểm tra lại chuỗi.
+    std::vector<size_t> cursors(lists.size(), 0);
+    for (uint32_t candidate : *lists[0]) {
+        bool inAll = true;
+        for (size_t i = 1; i < lists.size(); ++i) {
+            cursors[i] = gallop(*lists[i], cursors[i], candidate);
+            if (cursors[i] == lists[i]->size()) {
+                return results; // Danh sách này đã hết: không còn ứng viên nào
+            }
+            if ((*lists[i])[cursors[i]] != candidate) {
+                inAll = false;
+                break;
+            }
+        }
+        if (inAll && matches(candidate, foldedQuery, mode)) {
+            results.push_back(candidate);
+            if (results.size() >= limit) {
+                break;
+            }
+        }
+    }
+    return results;
+}
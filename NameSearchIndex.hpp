@@ -0,0 +1,50 @@
+#ifndef NAME_SEARCH_INDEX_HPP_
+#define NAME_SEARCH_INDEX_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+// Chuẩn hóa họ tên để tìm kiếm: chữ thường, bỏ dấu tiếng Việt (cả dạng dựng sẵn lẫn
+// dạng tổ hợp NFD), đ -> d, dấu câu/khoảng trắng liên tiếp gộp thành một khoảng trắng.
+// Ví dụ: "Nguyễn  Văn Ân" -> "nguyen van an".
+std::string foldName(std::string_view utf8);
+
+enum class NameMatchMode {
+    Substring, // Chuỗi con bất kỳ trong họ tên
+    Prefix     // Đầu của một từ trong họ tên ("ngu" khớp "Nguyễn", "an" khớp "Văn An")
+};
+
+// Chỉ mục trigram trên họ tên đã chuẩn hóa, theo vị trí sinh viên trong repository.
+// Danh sách vị trí của mỗi trigram được giữ tăng dần để giao nhiều danh sách bằng
+// tìm kiếm nhảy cóc (galloping); thêm ở cuối (trường hợp thường gặp) chỉ là push_back.
+class NameSearchIndex {
+public:
+    void insert(size_t slot, std::string_view name);
+    void erase(size_t slot);
+
+    // Sinh viên ở vị trí `from` được chuyển sang vị trí `to` (xóa kiểu swap-and-pop)
+    void relocate(size_t from, size_t to);
+
+    void clear();
+
+    // Trả về các vị trí có họ tên khớp `query`, tăng dần, tối đa `limit` kết quả
+    std::vector<size_t> search(const std::string& query, NameMatchMode mode = NameMatchMode::Substring,
+                               size_t limit = SIZE_MAX) const;
+
+    // Kiểm tra một vị trí với truy vấn đã chuẩn hóa bằng foldName()
+    bool matches(size_t slot, const std::string& foldedQuery, NameMatchMode mode) const;
+
+private:
+    using Posting = std::vector<uint32_t>;
+
+    static std::vector<uint32_t> trigramsOf(const std::string& text);
+
+    // Họ tên đã chuẩn hóa, có một khoảng trắng ở đầu để tìm đầu từ bằng " " + truy vấn
+    std::vector<std::string> folded_;
+    std::unordered_map<uint32_t, Posting> postings_;
+};
+
+#endif // NAME_SEARCH_INDEX_HPP_
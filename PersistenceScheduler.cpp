@@ -0,0 +1,98 @@
+#include "PersistenceScheduler.hpp"
+#include "Logger.hpp"
+#include <exception>
+
+PersistenceScheduler::PersistenceScheduler(std::chrono::milliseconds interval)
+    : interval_(interval), worker_(&PersistenceScheduler::workerLoop, this) {}
+
+PersistenceScheduler::~PersistenceScheduler() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    worker_.join();
+}
+
+void PersistenceScheduler::setInterval(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    interval_ = interval;
+}
+
+void PersistenceScheduler::schedule(const std::string& dataset, WriteTask task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto entry = pending_.find(dataset);
+        if (entry != pending_.end()) {
+            entry->second.task = std::move(task); // Giữ hạn cũ: thay đổi liên tục vẫn được ghi định kỳ
+            return;
+        }
+        pending_.emplace(dataset, Pending{std::move(task), std::chrono::steady_clock::now() + interval_});
+    }
+    wake_.notify_all();
+}
+
+void PersistenceScheduler::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (pending_.empty() && writing_.empty()) {
+        return;
+    }
+    flushing_ = true;
+    wake_.notify_all();
+    idle_.wait(lock, [this] { return pending_.empty() && writing_.empty(); });
+    flushing_ = false;
+}
+
+void PersistenceScheduler::discard(const std::string& dataset) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    pending_.erase(dataset);
+    idle_.wait(lock, [&] { return writing_ != dataset; });
+}
+
+bool PersistenceScheduler::isPending(const std::string& dataset) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return writing_ == dataset || pending_.count(dataset) > 0;
+}
+
+size_t PersistenceScheduler::writesCompleted() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return completed_;
+}
+
+void PersistenceScheduler::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        if (pending_.empty()) {
+            if (stopping_) {
+                return;
+            }
+            wake_.wait(lock);
+            continue;
+        }
+        // Tập dữ liệu đến hạn sớm nhất
+        auto next = pending_.begin();
+        for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+            if (it->second.due < next->second.due) {
+                next = it;
+            }
+        }
+        if (!flushing_ && !stopping_ && std::chrono::steady_clock::now() < next->second.due) {
+            wake_.wait_until(lock, next->second.due);
+            continue;
+        }
+        writing_ = next->first;
+        WriteTask task = std::move(next->second.task);
+        pending_.erase(next);
+        lock.unlock();
+        try {
+            task();
+        } catch (const std::exception& ex) {
+            Logger::getInstance().log("Background save of " + writing_ + " failed: " + ex.what(), LogLevel::Error);
+        }
+        lock.lock();
+        writing_.clear();
+        ++completed_;
+        idle_.notify_all();
+    }
+}
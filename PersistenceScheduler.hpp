@@ -0,0 +1,68 @@
+#ifndef PERSISTENCE_SCHEDULER_HPP_
+#define PERSISTENCE_SCHEDULER_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Ghi nền các tập dữ liệu (students.json, faculties.json, ...) đã thay đổi.
+//
+// Người gọi chụp dữ liệu cần ghi vào một tác vụ (chỉ sao chép trong bộ nhớ) và gọi
+// schedule(); luồng nền chạy tác vụ sau `interval` kể từ lần schedule đầu tiên của tập dữ
+// liệu đó, hoặc ngay khi flush(). Một tập dữ liệu được schedule nhiều lần trước khi đến
+// hạn chỉ được ghi một lần, với tác vụ mới nhất. Các tác vụ chạy lần lượt trên một luồng
+// nên hai lần ghi cùng một file không bao giờ chồng lên nhau.
+class PersistenceScheduler {
+public:
+    using WriteTask = std::function<void()>;
+
+    explicit PersistenceScheduler(std::chrono::milliseconds interval);
+    // Ghi nốt các tập dữ liệu đang chờ rồi dừng luồng nền
+    ~PersistenceScheduler();
+
+    PersistenceScheduler(const PersistenceScheduler&) = delete;
+    PersistenceScheduler& operator=(const PersistenceScheduler&) = delete;
+
+    void setInterval(std::chrono::milliseconds interval);
+
+    // Đặt (hoặc thay) tác vụ ghi của `dataset`
+    void schedule(const std::string& dataset, WriteTask task);
+
+    // Ghi ngay mọi tập dữ liệu đang chờ và đợi đến khi ghi xong
+    void flush();
+
+    // Bỏ lần ghi đang chờ của `dataset` và đợi lần ghi đang chạy (nếu có) của nó kết thúc,
+    // trước khi người gọi tự ghi file đó
+    void discard(const std::string& dataset);
+
+    // `dataset` đang chờ ghi hoặc đang được ghi
+    bool isPending(const std::string& dataset) const;
+
+    // Số lần ghi đã hoàn tất
+    size_t writesCompleted() const;
+
+private:
+    struct Pending {
+        WriteTask task;
+        std::chrono::steady_clock::time_point due;
+    };
+
+    void workerLoop();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_; // Có việc mới, flush hoặc dừng
+    std::condition_variable idle_; // Một lần ghi vừa xong
+    std::map<std::string, Pending> pending_;
+    std::string writing_;          // Tập dữ liệu đang được ghi (rỗng nếu không có)
+    std::chrono::milliseconds interval_;
+    size_t completed_ = 0;
+    bool flushing_ = false;
+    bool stopping_ = false;
+    std::thread worker_;
+};
+
+#endif // PERSISTENCE_SCHEDULER_HPP_
@@ -4,6 +4,26 @@
 #include <sstream>
 #include <iomanip>
 #include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Write one CSV field, quoting it when it contains a delimiter, quote or line break
+static void writeCSVField(std::ostream& out, const std::string& field) {
+    if (field.find_first_of(",\"\r\n") == std::string::npos) {
+        out << field;
+        return;
+    }
+    out << '"';
+    for (char c : field) {
+        if (c == '"') out << '"';
+        out << c;
+    }
+    out << '"';
+}
 
 bool RecordIO::exportToCSV(const std::string& filename, const std::vector<std::vector<std::string>>& records) {
     std::ofstream file(filename);
@@ -14,12 +34,12 @@ bool RecordIO::exportToCSV(const std::string& filename, const std::vector<std::v
 
     for (const auto& record : records) {
         for (size_t i = 0; i < record.size(); ++i) {
-            file << record[i];
+            writeCSVField(file, record[i]);
             if (i < record.size() - 1) {
                 file << ",";
             }
         }
-        file << std::endl;
+        file << '\n';
     }
 
     file.close();
@@ -29,31 +49,53 @@ bool RecordIO::exportToCSV(const std::string& filename, const std::vector<std::v
 
 std::vector<std::vector<std::string>> RecordIO::importFromCSV(const std::string& filename) {
     std::vector<std::vector<std::string>> records;
-    std::ifstream file(filename);
-    std::string line;
+    importFromCSV(filename, [&records](const std::vector<std::string>& record) {
+        records.push_back(record);
+    });
+    return records;
+}
 
-    if (!file.is_open()) {
+bool RecordIO::importFromCSV(const std::string& filename, const RecordCallback& onRecord) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
         std::cerr << "Error: Could not open file for reading: " << filename << std::endl;
-        return records; // Return an empty vector
+        return false;
     }
 
-    while (std::getline(file, line)) {
-        std::vector<std::string> record;
-        std::stringstream lineStream(line);
-        std::string cell;
+    CsvParser parser(onRecord);
+    struct stat st;
+    size_t size = (::fstat(fd, &st) == 0) ? static_cast<size_t>(st.st_size) : 0;
+    void* mapped = size > 0 ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
 
-        while (std::getline(lineStream, cell, ',')) {
-            record.push_back(cell);
+    if (mapped != MAP_FAILED) {
+        const char* data = static_cast<const char*>(mapped);
+        ::madvise(mapped, size, MADV_SEQUENTIAL);
+        // Parse window by window and drop pages already parsed, so resident
+        // memory stays flat regardless of the file size.
+        const size_t window = 16u << 20;
+        for (size_t offset = 0; offset < size; offset += window) {
+            size_t length = std::min(window, size - offset);
+            parser.feed(data + offset, length);
+            ::madvise(const_cast<char*>(data) + offset, length, MADV_DONTNEED);
+        }
+        ::munmap(mapped, size);
+    } else {
+        // Not mappable (empty file, pipe, ...): fall back to buffered reads
+        std::vector<char> buffer(1 << 16);
+        ssize_t n;
+        while ((n = ::read(fd, buffer.data(), buffer.size())) > 0) {
+            parser.feed(buffer.data(), static_cast<size_t>(n));
         }
-        records.push_back(record);
     }
+    parser.finish();
+    ::close(fd);
 
-    file.close();
     std::cout << "Successfully imported from CSV file: " << filename << std::endl;
-    return records;
+    return true;
 }
 
-bool RecordIO::exportToJSON(const std::string& filename, const std::vector<std::vector<std::string>>& records) {
+bool RecordIO::exportToJSON(const std::string& filename, const std::vector<std::vector<std::string>>& records,
+                            JsonOutputStyle style) {
     json j = json::array(); // Create a JSON array to hold the records
 
     for (const auto& record : records) {
@@ -70,7 +112,7 @@ bool RecordIO::exportToJSON(const std::string& filename, const std::vector<std::
         return false;
     }
 
-    file << std::setw(4) << j << std::endl; // Write JSON to file with indentation
+    file << dumpJson(j, style);
     file.close();
 
     std::cout << "Successfully exported to JSON file: " << filename << std::endl;
@@ -87,8 +129,11 @@ std::vector<std::vector<std::string>> RecordIO::importFromJSON(const std::string
     }
 
     try {
-        json j;
-        file >> j; // Read the entire JSON from the file
+        json j = parseJsonRecords(file);
+        // A JSON Lines file with a single record reads back as that record's array of strings
+        if (!j.empty() && std::all_of(j.begin(), j.end(), [](const json& cell) { return cell.is_string(); })) {
+            j = json::array({j});
+        }
 
         if (j.is_array()) {
             for (const auto& record_json : j) {
@@ -121,3 +166,134 @@ std::vector<std::vector<std::string>> RecordIO::importFromJSON(const std::string
     std::cout << "Successfully imported from JSON file: " << filename << std::endl;
     return records;
 }
+
+// Read-only memory map of a whole file; an empty file maps to size 0
+struct MappedFile {
+    explicit MappedFile(const std::string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        opened = true;
+        struct stat st;
+        size_t length = (::fstat(fd, &st) == 0) ? static_cast<size_t>(st.st_size) : 0;
+        void* mapped = length > 0 ? ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        if (mapped != MAP_FAILED) {
+            data = static_cast<const char*>(mapped);
+            size = length;
+        }
+        ::close(fd);
+    }
+    ~MappedFile() {
+        if (data) ::munmap(const_cast<char*>(data), size);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool opened = false;
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+// Offset of the first line that starts at or after `pos`
+static size_t nextLineStart(const char* data, size_t size, size_t pos) {
+    if (pos == 0 || pos >= size || data[pos - 1] == '\n') {
+        return std::min(pos, size);
+    }
+    const void* newline = std::memchr(data + pos, '\n', size - pos);
+    return newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) + 1 : size;
+}
+
+bool RecordIO::importFromNDJSON(const std::string& filename, const JsonRecordCallback& onRecord,
+                                size_t begin, size_t end) {
+    MappedFile file(filename);
+    if (!file.opened) {
+        std::cerr << "Error: Could not open file for reading: " << filename << std::endl;
+        return false;
+    }
+    const char* data = file.data;
+    end = std::min(end, file.size);
+    size_t pos = nextLineStart(data, file.size, begin);
+    if (data) {
+        ::madvise(const_cast<char*>(data), file.size, MADV_SEQUENTIAL);
+    }
+
+    // Pages already parsed are dropped window by window, as in the CSV import
+    const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t window = 16u << 20;
+    size_t released = pos & ~(pageSize - 1);
+    while (pos < end) {
+        const void* newline = std::memchr(data + pos, '\n', file.size - pos);
+        size_t lineEnd = newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) : file.size;
+        size_t contentEnd = lineEnd;
+        if (contentEnd > pos && data[contentEnd - 1] == '\r') --contentEnd;
+        if (std::any_of(data + pos, data + contentEnd, [](char c) { return c != ' ' && c != '\t'; })) {
+            json record = json::parse(data + pos, data + contentEnd, nullptr, false);
+            if (record.is_discarded()) {
+                std::cerr << "Warning: Malformed JSON line at byte " << pos << " in " << filename << ". Skipping.\n";
+            } else {
+                onRecord(record);
+            }
+        }
+        pos = lineEnd + 1;
+        if (pos - released >= window && pos < file.size) {
+            size_t upto = pos & ~(pageSize - 1);
+            ::madvise(const_cast<char*>(data) + released, upto - released, MADV_DONTNEED);
+            released = upto;
+        }
+    }
+    return true;
+}
+
+std::vector<std::pair<size_t, size_t>> RecordIO::splitNDJSON(const std::string& filename, size_t parts) {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    MappedFile file(filename);
+    if (!file.opened) {
+        std::cerr << "Error: Could not open file for reading: " << filename << std::endl;
+        return ranges;
+    }
+    parts = std::max<size_t>(parts, 1);
+    size_t begin = 0;
+    for (size_t part = 1; part <= parts && begin < file.size; ++part) {
+        size_t end = part == parts ? file.size : nextLineStart(file.data, file.size, file.size / parts * part);
+        if (end > begin) {
+            ranges.emplace_back(begin, end);
+            begin = end;
+        }
+    }
+    return ranges;
+}
+
+bool NDJSONWriter::open(const std::string& filename) {
+    close();
+    count_ = 0;
+    buffer_.clear();
+    buffer_.reserve(1 << 20);
+    file_.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+        std::cerr << "Error: Could not open file for writing: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void NDJSONWriter::write(const json& record) {
+    buffer_ += record.dump();
+    buffer_ += '\n';
+    ++count_;
+    if (buffer_.size() >= (1u << 20)) {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+}
+
+bool NDJSONWriter::close() {
+    if (!file_.is_open()) {
+        return true;
+    }
+    file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+    bool ok = static_cast<bool>(file_);
+    file_.close();
+    return ok && !file_.fail();
+}
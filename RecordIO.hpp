@@ -1,28 +1,74 @@
 #ifndef RECORDIO_HPP_
 #define RECORDIO_HPP_
 
+#include <cstdint>
+#include <fstream>
+#include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 #include "nlohmann/json.hpp"
+#include "CsvParser.hpp"
+#include "JsonFormat.hpp"
 
 using json = nlohmann::json;
 
 class RecordIO {
 public:
+    using RecordCallback = CsvParser::RecordCallback;
+
     // Default constructor
     RecordIO() = default;
 
-    // CSV Export
+    // CSV Export (fields containing commas, quotes or line breaks are quoted per RFC 4180)
     bool exportToCSV(const std::string& filename, const std::vector<std::vector<std::string>>& records);
 
     // CSV Import
     std::vector<std::vector<std::string>> importFromCSV(const std::string& filename);
 
-    // JSON Export
-    bool exportToJSON(const std::string& filename, const std::vector<std::vector<std::string>>& records);
+    // Streaming CSV Import: the file is memory-mapped and parsed in place, and each
+    // record is passed to onRecord as soon as it is complete. Memory use does not
+    // grow with the file size.
+    bool importFromCSV(const std::string& filename, const RecordCallback& onRecord);
+
+    // JSON Export (pretty, compact, or JSON Lines with one record array per line)
+    bool exportToJSON(const std::string& filename, const std::vector<std::vector<std::string>>& records,
+                      JsonOutputStyle style = JsonOutputStyle::Pretty);
 
-    // JSON Import
+    // JSON Import (accepts every JsonOutputStyle)
     std::vector<std::vector<std::string>> importFromJSON(const std::string& filename);
+
+    using JsonRecordCallback = std::function<void(const json& record)>;
+
+    // NDJSON Import: one JSON value per line, streamed from a memory map with one line
+    // parsed at a time, so memory use does not grow with the file size. Only lines that
+    // start inside [begin, end) are read; the ranges from splitNDJSON() can therefore be
+    // imported independently (e.g. in parallel). Malformed lines are reported and skipped.
+    bool importFromNDJSON(const std::string& filename, const JsonRecordCallback& onRecord,
+                          size_t begin = 0, size_t end = SIZE_MAX);
+
+    // Split an NDJSON file into at most `parts` byte ranges of similar size, each starting
+    // at the beginning of a line
+    std::vector<std::pair<size_t, size_t>> splitNDJSON(const std::string& filename, size_t parts);
+};
+
+// NDJSON Export: writes one compact JSON value per line as records are produced,
+// through a fixed-size buffer, so exporting never holds the whole data set in memory.
+class NDJSONWriter {
+public:
+    ~NDJSONWriter() { close(); }
+
+    bool open(const std::string& filename);
+    void write(const json& record);
+    // Flush the buffer and close the file; false if any write failed
+    bool close();
+
+    size_t count() const { return count_; }
+
+private:
+    std::ofstream file_;
+    std::string buffer_;
+    size_t count_ = 0;
 };
 
 #endif // RECORDIO_HPP_
@@ -0,0 +1,94 @@
+#include "RepositoryLock.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Các khóa đọc luồng này đang giữ; một khóa xuất hiện nhiều lần khi được khóa lồng nhau
+thread_local std::vector<const RepositoryLock*> heldShared;
+
+} // namespace
+
+bool RepositoryLock::heldSharedByCurrentThread() const {
+    return std::find(heldShared.begin(), heldShared.end(), this) != heldShared.end();
+}
+
+// Shard của luồng hiện tại: các luồng được chia lần lượt vào các shard
+size_t RepositoryLock::currentShard() {
+    static std::atomic<size_t> nextShard{0};
+    thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return shard;
+}
+
+size_t RepositoryLock::readerCount() const {
+    size_t count = 0;
+    for (const ReaderShard& shard : shards_) {
+        count += shard.readers.load();
+    }
+    return count;
+}
+
+bool RepositoryLock::lockShared() {
+    if (ownedByCurrentThread()) {
+        return false;
+    }
+    if (!heldSharedByCurrentThread()) {
+        // Lần khóa ngoài cùng của luồng này. Tăng shard trước rồi mới đọc cờ (cùng thứ tự
+        // seq_cst với luồng ghi: bật cờ rồi mới đếm), nên luồng ghi luôn thấy luồng đọc này
+        // hoặc luồng đọc này thấy cờ.
+        std::atomic<size_t>& readers = shards_[currentShard()].readers;
+        readers.fetch_add(1);
+        while (writerPending_.load()) {
+            readers.fetch_sub(1);
+            std::unique_lock<std::mutex> lock(mutex_);
+            changed_.notify_all(); // Luồng ghi có thể đang chờ shard này về 0
+            changed_.wait(lock, [this] { return !writerPending_.load(); });
+            lock.unlock();
+            readers.fetch_add(1);
+        }
+    }
+    heldShared.push_back(this);
+    return true;
+}
+
+void RepositoryLock::unlockShared() {
+    heldShared.erase(std::find(heldShared.rbegin(), heldShared.rend(), this).base() - 1);
+    if (!heldSharedByCurrentThread()) {
+        shards_[currentShard()].readers.fetch_sub(1);
+        if (writerPending_.load()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            changed_.notify_all();
+        }
+    }
+}
+
+void RepositoryLock::lock() {
+    if (ownedByCurrentThread()) {
+        ++writeDepth_;
+        return;
+    }
+    if (heldSharedByCurrentThread()) {
+        throw std::logic_error("RepositoryLock: cannot upgrade a read lock to a write lock");
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++waitingWriters_;
+        writerPending_.store(true);
+        changed_.wait(lock, [this] { return !writing_ && readerCount() == 0; });
+        --waitingWriters_;
+        writing_ = true;
+    }
+    writer_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    writeDepth_ = 1;
+}
+
+void RepositoryLock::unlock() {
+    if (--writeDepth_ == 0) {
+        writer_.store(std::thread::id(), std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex_);
+        writing_ = false;
+        writerPending_.store(waitingWriters_ > 0);
+        changed_.notify_all();
+    }
+}
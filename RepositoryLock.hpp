@@ -0,0 +1,95 @@
+#ifndef REPOSITORY_LOCK_HPP_
+#define REPOSITORY_LOCK_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Khóa đọc-ghi của StudentRepository: nhiều luồng đọc cùng lúc, một luồng ghi độc quyền.
+//
+// Luồng đang giữ khóa ghi có thể khóa lại (đọc hoặc ghi) mà không tự chặn mình: các thao tác
+// ghi của repository gọi lại các hàm công khai khác (ví dụ validator gọi isValidFaculty()
+// trong addStudent(), renameFaculty() mở một batch). Khóa đọc lồng nhau trên cùng một luồng
+// cũng được phép. Nâng khóa đọc lên khóa ghi thì không (hai luồng cùng nâng sẽ chặn nhau
+// mãi mãi): lock() ném std::logic_error trong trường hợp đó.
+//
+// Luồng ghi được ưu tiên: khi có luồng ghi đang chờ, lần khóa đọc ngoài cùng mới phải đợi,
+// nên luồng đọc liên tục không thể chặn luồng ghi mãi mãi (std::shared_mutex trên glibc
+// ưu tiên luồng đọc). Khóa đọc lồng nhau không phải đợi vì luồng đó đã giữ khóa.
+//
+// Bộ đếm luồng đọc được chia thành nhiều shard, mỗi shard một cache line; mỗi luồng dùng
+// cố định một shard. Khi không có luồng ghi, khóa/mở khóa đọc chỉ sửa shard của luồng đó
+// và đọc cờ writerPending_ (không ai ghi lên nó), nên các luồng đọc trên nhiều CPU không
+// tranh nhau một cache line. Chỉ luồng ghi phải cộng mọi shard; mutex_/changed_ chỉ dùng
+// khi có luồng ghi.
+class RepositoryLock {
+public:
+    RepositoryLock() = default;
+    RepositoryLock(const RepositoryLock&) = delete;
+    RepositoryLock& operator=(const RepositoryLock&) = delete;
+
+    // Trả về false nếu luồng này đang giữ khóa ghi (không cần khóa thêm, không cần unlockShared())
+    bool lockShared();
+    void unlockShared();
+
+    void lock();
+    void unlock();
+
+    // Luồng hiện tại đang giữ khóa ghi
+    bool ownedByCurrentThread() const {
+        return writer_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
+
+    class ReadGuard {
+    public:
+        explicit ReadGuard(RepositoryLock& lock) : lock_(lock), locked_(lock.lockShared()) {}
+        ~ReadGuard() {
+            if (locked_) lock_.unlockShared();
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        RepositoryLock& lock_;
+        bool locked_;
+    };
+
+    class WriteGuard {
+    public:
+        explicit WriteGuard(RepositoryLock& lock) : lock_(lock) { lock_.lock(); }
+        ~WriteGuard() { lock_.unlock(); }
+        WriteGuard(const WriteGuard&) = delete;
+        WriteGuard& operator=(const WriteGuard&) = delete;
+
+    private:
+        RepositoryLock& lock_;
+    };
+
+private:
+    static constexpr size_t kShards = 64;
+    static constexpr size_t kCacheLine = 64;
+
+    struct alignas(kCacheLine) ReaderShard {
+        std::atomic<size_t> readers{0};
+    };
+
+    bool heldSharedByCurrentThread() const;
+    static size_t currentShard();
+    size_t readerCount() const;
+
+    ReaderShard shards_[kShards];
+
+    // Có luồng ghi đang giữ hoặc đang chờ khóa: luồng đọc mới phải qua mutex_
+    alignas(kCacheLine) std::atomic<bool> writerPending_{false};
+    std::atomic<std::thread::id> writer_{}; // Luồng đang giữ khóa ghi (rỗng nếu không có)
+    size_t writeDepth_ = 0;                 // Chỉ luồng giữ khóa ghi đọc/ghi
+
+    alignas(kCacheLine) std::mutex mutex_;  // Bảo vệ waitingWriters_, writing_
+    std::condition_variable changed_;
+    size_t waitingWriters_ = 0;
+    bool writing_ = false;
+};
+
+#endif // REPOSITORY_LOCK_HPP_
@@ -1,4 +1,6 @@
 #include "StatusRulesManager.hpp"
+#include "ConfigManager.hpp"
+#include "AtomicFile.hpp"
 
 StatusRulesManager& StatusRulesManager::getInstance() {
     static StatusRulesManager instance;
@@ -43,13 +45,10 @@ void StatusRulesManager::saveRules() {
     for (const auto& pair : rules) {
         j[pair.first] = pair.second;
     }
-    std::ofstream file(rulesFilename);
-    if (file.is_open()) {
-        file << std::setw(4) << j << std::endl;
-        file.close();
+    if (writeFileAtomic(rulesFilename, dumpJson(j, ConfigManager::getInstance().getJsonOutputStyle()))) {
         std::cout << "Lưu quy luật thành công vào file: " << rulesFilename << "\n";
     } else {
-        std::cerr << "Lỗi khi mở file để lưu quy luật: " << rulesFilename << std::endl;
+        std::cerr << "Lỗi khi lưu quy luật vào file: " << rulesFilename << std::endl;
     }
 }
 
@@ -1,13 +1,49 @@
 #ifndef STUDENT_HPP_
 #define STUDENT_HPP_
 
+#include <string>
+#include <string_view>
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <unordered_map>
+#include <set>
+#include <unordered_set>
+#include <map>
+#include <regex>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <sys/stat.h>
 #include "ConfigManager.hpp"
 #include "Logger.hpp"
+#include "StudentJournal.hpp"
+#include "StudentSnapshot.hpp"
+#include "StudentJsonReader.hpp"
+#include "RecordIO.hpp"
+#include "AtomicFile.hpp"
+#include "PersistenceScheduler.hpp"
+#include "RepositoryLock.hpp"
+#include "ThreadPool.hpp"
+#include "StudentIndex.hpp"
+#include "StudentDictionary.hpp"
+#include "NameSearchIndex.hpp"
+#include "FuzzyIndex.hpp"
+#include "StudentQuery.hpp"
+#include "StudentColumns.hpp"
 
 // Forward declaration
 class Student;
 
-std::string timePointToISO8601(const std::chrono::system_clock::time_point& tp) {
+inline std::string timePointToISO8601(const std::chrono::system_clock::time_point& tp) {
     std::time_t time = std::chrono::system_clock::to_time_t(tp);
     std::tm tm = *std::gmtime(&time);
     std::stringstream ss;
@@ -16,7 +52,7 @@ std::string timePointToISO8601(const std::chrono::system_clock::time_point& tp)
 }
 
 // Chuyển chuỗi ISO 8601 (UTC) thành time_point
-std::chrono::system_clock::time_point iso8601ToTimePoint(const std::string &s) {
+inline std::chrono::system_clock::time_point iso8601ToTimePoint(const std::string &s) {
     std::tm tm = {};
     std::istringstream iss(s);
     iss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%SZ");
@@ -28,90 +64,138 @@ std::chrono::system_clock::time_point iso8601ToTimePoint(const std::string &s) {
 // Lớp cơ sở cho Sinh viên
 class Student {
 public:
+    // Bộ cấp phát cho các trường chuỗi. Mặc định dùng heap; repository truyền arena của nó
+    // để mọi chuỗi của dữ liệu đã nạp nằm chung một vùng nhớ và được giải phóng một lần.
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
     // Constructor
-    Student(std::string id, std::string name, std::string dob, std::string gender,
-            std::string faculty, std::string course, std::string program, std::string address,
-            std::string email, std::string phone, std::string status)
-      : id_(id), name_(name), dob_(dob), gender_(gender), faculty_(faculty),
-        course_(course), program_(program), address_(address), email_(email),
-        phone_(phone), status_(status), creationTime_(std::chrono::system_clock::now()) {}
+    Student(std::string_view id, std::string_view name, std::string_view dob, std::string_view gender,
+            std::string_view faculty, std::string_view course, std::string_view program, std::string_view address,
+            std::string_view email, std::string_view phone, std::string_view status,
+            const allocator_type& alloc = {})
+      : id_(id, alloc), name_(name, alloc), dob_(dob, alloc),
+        gender_(StudentDictionaries::getInstance().gender.intern(gender)),
+        faculty_(StudentDictionaries::getInstance().faculty.intern(faculty)),
+        course_(course, alloc),
+        program_(StudentDictionaries::getInstance().program.intern(program)),
+        address_(address, alloc), email_(email, alloc), phone_(phone, alloc),
+        status_(StudentDictionaries::getInstance().status.intern(status)),
+        creationTime_(std::chrono::system_clock::now()) {}
+
+    // Sao chép/chuyển sinh viên sang bộ cấp phát khác (ví dụ: vào arena của repository).
+    // Bản sao thông thường (copy constructor) luôn dùng heap nên không phụ thuộc arena.
+    Student(const Student& other, const allocator_type& alloc)
+      : id_(other.id_, alloc), name_(other.name_, alloc), dob_(other.dob_, alloc),
+        gender_(other.gender_), faculty_(other.faculty_), course_(other.course_, alloc),
+        program_(other.program_), address_(other.address_, alloc), email_(other.email_, alloc),
+        phone_(other.phone_, alloc), status_(other.status_), creationTime_(other.creationTime_) {}
+
+    Student(Student&& other, const allocator_type& alloc)
+      : id_(std::move(other.id_), alloc), name_(std::move(other.name_), alloc), dob_(std::move(other.dob_), alloc),
+        gender_(other.gender_), faculty_(other.faculty_), course_(std::move(other.course_), alloc),
+        program_(other.program_), address_(std::move(other.address_), alloc),
+        email_(std::move(other.email_), alloc), phone_(std::move(other.phone_), alloc),
+        status_(other.status_), creationTime_(other.creationTime_) {}
+
+    Student(const Student&) = default;
+    Student(Student&&) noexcept = default; // vector<Student> chuyển (không sao chép) khi cấp phát lại
+    Student& operator=(const Student&) = default;
+    Student& operator=(Student&&) = default;
+    virtual ~Student() = default;
 
     // Phương thức ảo để hiển thị thông tin sinh viên (cho mục đích kế thừa)
     virtual void displayInfo() const {
         std::cout << "MSSV: " << id_ << "\n";
         std::cout << "Họ tên: " << name_ << "\n";
         std::cout << "Ngày sinh: " << dob_ << "\n";
-        std::cout << "Giới tính: " << gender_ << "\n";
-        std::cout << "Khoa: " << faculty_ << "\n";
+        std::cout << "Giới tính: " << getGender() << "\n";
+        std::cout << "Khoa: " << getFaculty() << "\n";
         std::cout << "Khóa: " << course_ << "\n";
-        std::cout << "Chương trình: " << program_ << "\n";
+        std::cout << "Chương trình: " << getProgram() << "\n";
         std::cout << "Địa chỉ: " << address_ << "\n";
         std::cout << "Email: " << email_ << "\n";
         std::cout << "Số điện thoại: " << phone_ << "\n";
-        std::cout << "Tình trạng: " << status_ << "\n";
-    }
-
-    // Getter methods
-    std::string getId() const { return id_; }
-    std::string getName() const { return name_; }
-    std::string getDob() const { return dob_; }
-    std::string getAddress() const { return address_; }
-    std::string getGender() const { return gender_; }
-    std::string getCourse() const { return course_; }
-    std::string getProgram() const { return program_; }
-    std::string getEmail() const { return email_; }
-    std::string getPhone() const { return phone_; }
-    std::string getStatus() const { return status_; }
-    std::string getFaculty() const { return faculty_; }
+        std::cout << "Tình trạng: " << getStatus() << "\n";
+    }
+
+    // Getter methods (trả về bản sao; trong vòng lặp nên dùng get...View() bên dưới)
+    std::string getId() const { return std::string(id_); }
+    std::string getName() const { return std::string(name_); }
+    std::string getDob() const { return std::string(dob_); }
+    std::string getAddress() const { return std::string(address_); }
+    const std::string& getGender() const { return StudentDictionaries::getInstance().gender.value(gender_); }
+    std::string getCourse() const { return std::string(course_); }
+    const std::string& getProgram() const { return StudentDictionaries::getInstance().program.value(program_); }
+    std::string getEmail() const { return std::string(email_); }
+    std::string getPhone() const { return std::string(phone_); }
+    const std::string& getStatus() const { return StudentDictionaries::getInstance().status.value(status_); }
+    const std::string& getFaculty() const { return StudentDictionaries::getInstance().faculty.value(faculty_); }
     std::chrono::system_clock::time_point getCreationTime() const { return creationTime_; }
 
+    // Truy cập không cấp phát: view vào chuỗi của sinh viên, hợp lệ tới khi sinh viên bị sửa/hủy
+    std::string_view getIdView() const noexcept { return id_; }
+    std::string_view getNameView() const noexcept { return name_; }
+    std::string_view getDobView() const noexcept { return dob_; }
+    std::string_view getCourseView() const noexcept { return course_; }
+    std::string_view getAddressView() const noexcept { return address_; }
+    std::string_view getEmailView() const noexcept { return email_; }
+    std::string_view getPhoneView() const noexcept { return phone_; }
+
+    // Mã trong từ điển dùng chung (StudentDictionaries); so sánh mã thay cho so sánh chuỗi
+    uint32_t getGenderCode() const { return gender_; }
+    uint32_t getFacultyCode() const { return faculty_; }
+    uint32_t getProgramCode() const { return program_; }
+    uint32_t getStatusCode() const { return status_; }
+
     // Setter methods
-    void setId(const std::string& id) { id_ = id; }
-    void setName(const std::string& name) { name_ = name; }
-    void setDob(const std::string& dob) { dob_ = dob; }
-    void setGender(const std::string& gender) { gender_ = gender; }
-    void setFaculty(const std::string& faculty) { faculty_ = faculty; }
-    void setCourse(const std::string& course) { course_ = course; }
-    void setProgram(const std::string& program) { program_ = program; }
-    void setAddress(const std::string& address) { address_ = address; }
-    void setEmail(const std::string& email) { email_ = email; }
-    void setPhone(const std::string& phone) { phone_ = phone; }
-    void setStatus(const std::string& status) { status_ = status; }
+    void setId(std::string_view id) { id_ = id; }
+    void setName(std::string_view name) { name_ = name; }
+    void setDob(std::string_view dob) { dob_ = dob; }
+    void setGender(std::string_view gender) { gender_ = StudentDictionaries::getInstance().gender.intern(gender); }
+    void setFaculty(std::string_view faculty) { faculty_ = StudentDictionaries::getInstance().faculty.intern(faculty); }
+    void setCourse(std::string_view course) { course_ = course; }
+    void setProgram(std::string_view program) { program_ = StudentDictionaries::getInstance().program.intern(program); }
+    void setAddress(std::string_view address) { address_ = address; }
+    void setEmail(std::string_view email) { email_ = email; }
+    void setPhone(std::string_view phone) { phone_ = phone; }
+    void setStatus(std::string_view status) { status_ = StudentDictionaries::getInstance().status.intern(status); }
     void setCreationTime(const std::chrono::system_clock::time_point& t) { creationTime_ = t; }
 
     // Method to serialize Student object to JSON
     json toJson() const {
         return {
-            {"id", id_},
-            {"name", name_},
-            {"dob", dob_},
-            {"gender", gender_},
-            {"faculty", faculty_},
-            {"course", course_},
-            {"program", program_},
-            {"address", address_},
-            {"email", email_},
-            {"phone", phone_},
-            {"status", status_},
+            {"id", std::string_view(id_)},
+            {"name", std::string_view(name_)},
+            {"dob", std::string_view(dob_)},
+            {"gender", getGender()},
+            {"faculty", getFaculty()},
+            {"course", std::string_view(course_)},
+            {"program", getProgram()},
+            {"address", std::string_view(address_)},
+            {"email", std::string_view(email_)},
+            {"phone", std::string_view(phone_)},
+            {"status", getStatus()},
             {"creationTime", timePointToISO8601(creationTime_)},
         };
     }
 
     // Static method to create Student object from JSON
-    static Student fromJson(const json& j) {
-        // Tạo đối tượng sinh viên ban đầu (không truyền creationTime vào constructor)
+    static Student fromJson(const json& j, const allocator_type& alloc = {}) {
+        // Tạo đối tượng sinh viên ban đầu (không truyền creationTime vào constructor);
+        // đọc chuỗi qua tham chiếu để không tạo bản sao trung gian
         Student s(
-            j["id"].get<std::string>(),
-            j["name"].get<std::string>(),
-            j["dob"].get<std::string>(),
-            j["gender"].get<std::string>(),
-            j["faculty"].get<std::string>(),
-            j["course"].get<std::string>(),
-            j["program"].get<std::string>(),
-            j["address"].get<std::string>(),
-            j["email"].get<std::string>(),
-            j["phone"].get<std::string>(),
-            j["status"].get<std::string>()
+            j["id"].get_ref<const std::string&>(),
+            j["name"].get_ref<const std::string&>(),
+            j["dob"].get_ref<const std::string&>(),
+            j["gender"].get_ref<const std::string&>(),
+            j["faculty"].get_ref<const std::string&>(),
+            j["course"].get_ref<const std::string&>(),
+            j["program"].get_ref<const std::string&>(),
+            j["address"].get_ref<const std::string&>(),
+            j["email"].get_ref<const std::string&>(),
+            j["phone"].get_ref<const std::string&>(),
+            j["status"].get_ref<const std::string&>(),
+            alloc
         );
         // Cập nhật trường creationTime từ chuỗi ISO 8601
         s.setCreationTime(iso8601ToTimePoint(j["creationTime"].get<std::string>()));
@@ -119,17 +203,17 @@ public:
     }
 
 private:
-    std::string id_;
-    std::string name_;
-    std::string dob_;
-    std::string gender_;
-    std::string faculty_;
-    std::string course_;
-    std::string program_;
-    std::string address_;
-    std::string email_;
-    std::string phone_;
-    std::string status_;
+    std::pmr::string id_;
+    std::pmr::string name_;
+    std::pmr::string dob_;
+    uint32_t gender_;   // Mã trong StudentDictionaries::gender
+    uint32_t faculty_;  // Mã trong StudentDictionaries::faculty
+    std::pmr::string course_;
+    uint32_t program_;  // Mã trong StudentDictionaries::program
+    std::pmr::string address_;
+    std::pmr::string email_;
+    std::pmr::string phone_;
+    uint32_t status_;   // Mã trong StudentDictionaries::status
     std::chrono::system_clock::time_point creationTime_;
 };
 
@@ -137,9 +221,27 @@ private:
 class StudentValidator {
 public:
     virtual bool isValid(const Student& student) = 0;
+
+    // Kiểm tra một bản ghi nhập (11 trường theo thứ tự của getAllStudentsAsStrings, có thể thêm
+    // creationTime) mà không tạo Student. Được gọi đồng thời từ nhiều luồng khi nhập hàng loạt
+    // nên không được thay đổi trạng thái hay in ra màn hình; lý do bị từ chối được ghi vào `error`.
+    virtual bool isValidRecord(const std::vector<std::string>& record, std::string& error) const = 0;
+
+    // Gọi một lần (trên luồng chính) trước khi isValidRecord được gọi song song
+    virtual void prepareRecordValidation() {}
+
     virtual ~StudentValidator() = default;
 };
 
+// Kết quả của các thao tác ghi tryAddStudent/tryUpdateStudent/tryRemoveStudent
+enum class StudentWriteResult {
+    Ok,
+    NotFound,      // Không có sinh viên với MSSV đã cho
+    DuplicateId,   // MSSV (mới) đã thuộc về sinh viên khác
+    Invalid,       // Validator từ chối
+    Rejected,      // Hàm sửa của tryUpdateStudent từ chối
+    DeleteExpired  // Quá thời hạn được xóa kể từ lúc tạo
+};
 
 class StudentRepository {
 public:
@@ -148,9 +250,9 @@ public:
         return instance;
     }
 
-    bool isStudentIdExists(const std::string& id) const {
-    return std::any_of(students_.begin(), students_.end(),
-                       [&](const Student& student) { return student.getId() == id; });
+    bool isStudentIdExists(std::string_view id) const {
+        RepositoryLock::ReadGuard guard(lock_);
+        return idIndex_.find(idKey(id)) != idIndex_.end();
     }
 
     std::string getSafeInput(const std::string& prompt) {
@@ -161,18 +263,17 @@ public:
     }
 
     bool deleteFaculty(const std::string &faculty) {
-    // Kiểm tra xem có sinh viên nào thuộc khoa này không
-        for (const auto &student : students_) {
-            if (student.getFaculty() == faculty) {
-                std::cout << "Không thể xóa khoa '" << faculty << "' vì có sinh viên được gán vào khoa này.\n";
-                return false;
-            }
+        RepositoryLock::WriteGuard guard(lock_);
+        // Kiểm tra xem có sinh viên nào thuộc khoa này không
+        if (facultyIndex_.count(faculty) > 0) {
+            std::cout << "Không thể xóa khoa '" << faculty << "' vì có sinh viên được gán vào khoa này.\n";
+            return false;
         }
         // Nếu không có sinh viên nào thuộc khoa này, tiến hành xóa khỏi danh sách khoa
         auto it = std::remove(faculties_.begin(), faculties_.end(), faculty);
         if (it != faculties_.end()) {
             faculties_.erase(it, faculties_.end());
-            saveDataToFile(facultyFilename_, faculties_);
+            persistList(facultyFilename_, faculties_);
             std::cout << "Đã xóa khoa: " << faculty << "\n";
             return true;
         }
@@ -182,16 +283,15 @@ public:
 
     // Xóa tình trạng nếu không có sinh viên nào sử dụng tình trạng đó.
     bool deleteStatus(const std::string &status) {
-        for (const auto &student : students_) {
-            if (student.getStatus() == status) {
-                std::cout << "Không thể xóa tình trạng '" << status << "' vì có sinh viên được gán vào tình trạng này.\n";
-                return false;
-            }
+        RepositoryLock::WriteGuard guard(lock_);
+        if (statusIndex_.count(status) > 0) {
+            std::cout << "Không thể xóa tình trạng '" << status << "' vì có sinh viên được gán vào tình trạng này.\n";
+            return false;
         }
         auto it = std::remove(statuses_.begin(), statuses_.end(), status);
         if (it != statuses_.end()) {
             statuses_.erase(it, statuses_.end());
-            saveDataToFile(statusFilename_, statuses_);
+            persistList(statusFilename_, statuses_);
             std::cout << "Đã xóa tình trạng: " << status << "\n";
             return true;
         }
@@ -201,16 +301,15 @@ public:
 
     // Xóa chương trình đào tạo nếu không có sinh viên nào được gán vào chương trình đó.
     bool deleteProgram(const std::string &program) {
-        for (const auto &student : students_) {
-            if (student.getProgram() == program) {
-                std::cout << "Không thể xóa chương trình '" << program << "' vì có sinh viên được gán vào chương trình này.\n";
-                return false;
-            }
+        RepositoryLock::WriteGuard guard(lock_);
+        if (programIndex_.count(program) > 0) {
+            std::cout << "Không thể xóa chương trình '" << program << "' vì có sinh viên được gán vào chương trình này.\n";
+            return false;
         }
         auto it = std::remove(programs_.begin(), programs_.end(), program);
         if (it != programs_.end()) {
             programs_.erase(it, programs_.end());
-            saveDataToFile(programFilename_, programs_);
+            persistList(programFilename_, programs_);
             std::cout << "Đã xóa chương trình: " << program << "\n";
             return true;
         }
@@ -218,19 +317,24 @@ public:
         return false;
     }
 
-    void addStudent(const Student& student) {
+    // Trả về true nếu sinh viên đã được thêm
+    bool addStudent(const Student& student) {
+        return tryAddStudent(student) == StudentWriteResult::Ok;
+    }
+
+    // Kiểm tra MSSV, kiểm tra hợp lệ và thêm sinh viên dưới cùng một khóa ghi
+    StudentWriteResult tryAddStudent(const Student& student) {
+        RepositoryLock::WriteGuard guard(lock_);
         // Kiểm tra xem MSSV đã tồn tại hay chưa
-        for (const auto& existingStudent : students_) {
-            if (existingStudent.getId() == student.getId()) {
-                std::cout << "Lỗi: MSSV " << student.getId() << " đã tồn tại!\n";
-                Logger::getInstance().log("Failed to add student - ID already exists: " + student.getId());
-                return;
-            }
+        if (isStudentIdExists(student.getId())) {
+            std::cout << "Lỗi: MSSV " << student.getId() << " đã tồn tại!\n";
+            Logger::getInstance().log("Failed to add student - ID already exists: " + student.getId());
+            return StudentWriteResult::DuplicateId;
         }
 
         if (validator_ == nullptr) {
             std::cerr << "Validator chưa được thiết lập!\n";
-            return;
+            return StudentWriteResult::Invalid;
         }
 
         if (validator_->isValid(student)) {
@@ -238,164 +342,716 @@ public:
             Student newStudent = student;
             newStudent.setCreationTime(std::chrono::system_clock::now()); // Cập nhật thời gian tạo
 
-            students_.push_back(newStudent);
-            saveStudentDataToFile();
+            appendStudent(heapRow(std::move(newStudent)));
+            recordPut(*students_.back());
+            persistChanges();
             std::cout << "Đã thêm sinh viên thành công.\n";
             Logger::getInstance().log("Added student with ID: " + student.getId());
-        } else {
-            std::cout << "Không thể thêm sinh viên do thông tin không hợp lệ.\n";
-            Logger::getInstance().log("Failed to add student due to invalid information.");
+            return StudentWriteResult::Ok;
         }
+        std::cout << "Không thể thêm sinh viên do thông tin không hợp lệ.\n";
+        Logger::getInstance().log("Failed to add student due to invalid information.");
+        return StudentWriteResult::Invalid;
     }
 
 
     bool removeStudent(const std::string& id) {
-        auto it = std::find_if(students_.begin(), students_.end(),
-                               [&](const Student& s) { return s.getId() == id; });
-        if (it != students_.end()) {
+        return tryRemoveStudent(id) == StudentWriteResult::Ok;
+    }
+
+    StudentWriteResult tryRemoveStudent(const std::string& id) {
+        RepositoryLock::WriteGuard guard(lock_);
+        auto entry = idIndex_.find(id);
+        if (entry != idIndex_.end()) {
+            const Student& student = *students_[entry->second];
             // Lấy thời gian hiện tại
             if (ConfigManager::getInstance().getEnforceValidation()) {
                 auto now = std::chrono::system_clock::now();
-                auto diff = std::chrono::duration_cast<std::chrono::minutes>(now - it->getCreationTime());
+                auto diff = std::chrono::duration_cast<std::chrono::minutes>(now - student.getCreationTime());
                 int allowed = ConfigManager::getInstance().getDeleteTimeLimit();
                 if (diff.count() > allowed) {
                     std::cout << "Không được phép xóa sinh viên sau " << allowed << " phút kể từ thời điểm tạo.\n";
-                    return false;
+                    return StudentWriteResult::DeleteExpired;
                 }
             }
             // Nếu hợp lệ, xóa sinh viên
-            students_.erase(it);
-            saveStudentDataToFile();
+            eraseSlot(entry->second);
+            recordRemove(id);
+            persistChanges();
             std::cout << "Đã xóa sinh viên thành công.\n";
             Logger::getInstance().log("Removed student with ID: " + id);
-            return true;
+            return StudentWriteResult::Ok;
         } else {
             std::cout << "Không tìm thấy sinh viên với MSSV này.\n";
+            return StudentWriteResult::NotFound;
+        }
+    }
+
+    // Trả về con trỏ tới sinh viên trong repository (nullptr nếu không có).
+    // Chỉ đọc: mọi thay đổi phải qua updateStudent() để chỉ mục và kho cột luôn đúng.
+    // Con trỏ chỉ hợp lệ đến lần ghi kế tiếp; khi có luồng khác ghi, giữ readLock() trong
+    // lúc dùng con trỏ hoặc dùng getStudent().
+    const Student* findStudent(std::string_view id) const {
+        RepositoryLock::ReadGuard guard(lock_);
+        auto entry = idIndex_.find(idKey(id));
+        return entry != idIndex_.end() ? students_[entry->second].get() : nullptr;
+    }
+
+    // Bản sao (trên heap) của sinh viên có MSSV `id`, không phụ thuộc các lần ghi sau đó
+    std::optional<Student> getStudent(std::string_view id) const {
+        RepositoryLock::ReadGuard guard(lock_);
+        auto entry = idIndex_.find(idKey(id));
+        if (entry == idIndex_.end()) {
+            return std::nullopt;
+        }
+        return Student(*students_[entry->second]);
+    }
+
+    // Mọi hàm công khai tự lấy khóa đọc hoặc ghi. readLock() giữ khóa đọc qua nhiều lần gọi
+    // (ví dụ findStudent() rồi dùng con trỏ) để không lần ghi nào chen vào giữa.
+    RepositoryLock::ReadGuard readLock() const {
+        return RepositoryLock::ReadGuard(lock_);
+    }
+
+    // Ghi đè thông tin sinh viên có MSSV `id` (kể cả khi đổi MSSV) và lưu file.
+    bool updateStudent(const std::string& id, const Student& updated) {
+        RepositoryLock::WriteGuard guard(lock_);
+        auto entry = idIndex_.find(id);
+        if (entry == idIndex_.end()) {
+            std::cout << "Không tìm thấy sinh viên với MSSV này.\n";
+            return false;
+        }
+        if (updated.getIdView() != id && isStudentIdExists(updated.getIdView())) {
+            std::cout << "Lỗi: MSSV " << updated.getId() << " đã tồn tại!\n";
+            Logger::getInstance().log("Failed to update student - ID already exists: " + updated.getId());
             return false;
         }
+        replaceStudent(entry->second, updated);
+        return true;
     }
 
-    Student* findStudent(const std::string& id) {
-        for (Student& student : students_) {
-            if (student.getId() == id) {
-                return &student;
-            }
+    // Sửa sinh viên có MSSV `id` dưới cùng một khóa ghi: `edit` nhận bản sao hiện tại và
+    // trả về false để từ chối (Rejected); bản đã sửa còn phải có MSSV chưa dùng và qua
+    // validator. `edit` chạy khi đang giữ khóa ghi nên không được chờ luồng khác.
+    StudentWriteResult tryUpdateStudent(const std::string& id, const std::function<bool(Student&)>& edit) {
+        RepositoryLock::WriteGuard guard(lock_);
+        auto entry = idIndex_.find(id);
+        if (entry == idIndex_.end()) {
+            return StudentWriteResult::NotFound;
+        }
+        size_t slot = entry->second;
+        Student edited(*students_[slot]);
+        if (!edit(edited)) {
+            return StudentWriteResult::Rejected;
         }
-        return nullptr;
+        if (edited.getIdView() != id && isStudentIdExists(edited.getIdView())) {
+            return StudentWriteResult::DuplicateId;
+        }
+        if (validator_ == nullptr || !validator_->isValid(edited)) {
+            return StudentWriteResult::Invalid;
+        }
+        replaceStudent(slot, edited);
+        Logger::getInstance().log("Updated student with ID: " + edited.getId());
+        return StudentWriteResult::Ok;
     }
 
+    // Tìm sinh viên theo khoa, có thể lọc thêm theo họ tên (không phân biệt hoa thường/dấu)
     std::vector<Student> searchStudents(const std::string& faculty, const std::string& name = "") {
+        RepositoryLock::ReadGuard guard(lock_);
+        std::vector<Student> results;
+        if (name.empty()) {
+            for (size_t slot : facultyIndex_.find(faculty)) {
+                results.push_back(*students_[slot]);
+            }
+            return results;
+        }
+        uint32_t facultyCode;
+        if (!StudentDictionaries::getInstance().faculty.lookup(faculty, facultyCode)) {
+            return results;
+        }
+        for (size_t slot : nameIndex_.search(name)) {
+            if (students_[slot]->getFacultyCode() == facultyCode) {
+                results.push_back(*students_[slot]);
+            }
+        }
+        return results;
+    }
+
+    // Tìm theo họ tên qua chỉ mục trigram: không phân biệt hoa thường, có dấu hay không
+    // ("Nguyen" khớp "Nguyễn"). Prefix chỉ khớp đầu từ.
+    std::vector<Student> searchByName(const std::string& query,
+                                      NameMatchMode mode = NameMatchMode::Substring,
+                                      size_t limit = SIZE_MAX) const {
+        RepositoryLock::ReadGuard guard(lock_);
+        std::vector<Student> results;
+        for (size_t slot : nameIndex_.search(query, mode, limit)) {
+            results.push_back(*students_[slot]);
+        }
+        return results;
+    }
+
+    // Thực thi truy vấn nhiều điều kiện (AND). Chọn chỉ mục có ít ứng viên nhất (MSSV,
+    // khoa/tình trạng/chương trình/khóa bằng một giá trị, hoặc họ tên ~), rồi kiểm tra các
+    // điều kiện còn lại trên từng ứng viên theo thứ tự lưu trữ và áp dụng OFFSET/LIMIT.
+    std::vector<Student> query(const StudentQuery& query, QueryStats* stats = nullptr) const {
+        RepositoryLock::ReadGuard guard(lock_);
         std::vector<Student> results;
-        for (const Student& student : students_) {
-            if (student.getFaculty() == faculty) {
-                if (name.empty() || (student.getName().find(name) != std::string::npos)) {
-                    results.push_back(student);
+        QueryStats local;
+        std::vector<CompiledPredicate> predicates;
+        bool impossible = false;
+        for (const QueryPredicate& predicate : query.predicates) {
+            predicates.push_back(compilePredicate(predicate, impossible));
+        }
+        if (!impossible && query.limit > 0) {
+            size_t skipped = 0;
+            // Trả về false khi đã đủ LIMIT để dừng sớm
+            auto visit = [&](size_t slot) {
+                ++local.candidates;
+                for (const CompiledPredicate& predicate : predicates) {
+                    if (!matchesPredicate(slot, predicate)) {
+                        return true;
+                    }
+                }
+                if (skipped < query.offset) {
+                    ++skipped;
+                    return true;
+                }
+                results.push_back(*students_[slot]);
+                return results.size() < query.limit;
+            };
+            std::vector<size_t> candidates;
+            if (selectCandidates(predicates, candidates, local.index)) {
+                for (size_t slot : candidates) {
+                    if (!visit(slot)) break;
+                }
+            } else {
+                for (size_t slot = 0; slot < students_.size(); ++slot) {
+                    if (!visit(slot)) break;
                 }
             }
         }
+        if (stats != nullptr) {
+            *stats = local;
+        }
+        return results;
+    }
+
+    // Tìm gần đúng (gõ sai MSSV/họ tên): tối đa `k` sinh viên có MSSV hoặc họ tên đã bỏ dấu
+    // gần `query` nhất theo khoảng cách chỉnh sửa, xếp từ gần đến xa.
+    std::vector<Student> fuzzySearch(const std::string& query, size_t k = 10) {
+        RepositoryLock::ReadGuard guard(lock_);
+        buildFuzzyIndexes();
+        std::string foldedQuery = foldName(query);
+        int idMaxDistance = query.size() <= 4 ? 1 : 2;
+        int nameMaxDistance = std::max(1, std::min(4, static_cast<int>(foldedQuery.size()) / 3));
+        std::vector<FuzzyIndex::Match> matches = idFuzzy_.search(query, k, idMaxDistance);
+        std::vector<FuzzyIndex::Match> byName = nameFuzzy_.search(foldedQuery, k, nameMaxDistance);
+        matches.insert(matches.end(), byName.begin(), byName.end());
+        std::stable_sort(matches.begin(), matches.end(), [](const FuzzyIndex::Match& a, const FuzzyIndex::Match& b) {
+            return a.distance < b.distance;
+        });
+        std::vector<Student> results;
+        std::unordered_set<std::string> seen;
+        for (const FuzzyIndex::Match& match : matches) {
+            if (results.size() >= k) {
+                break;
+            }
+            auto entry = idIndex_.find(match.key);
+            if (entry != idIndex_.end() && seen.insert(match.key).second) {
+                results.push_back(*students_[entry->second]);
+            }
+        }
         return results;
     }
 
+    // Số sinh viên đang thuộc khoa/tình trạng/chương trình/khóa (tra chỉ mục, O(1))
+    size_t countByFaculty(const std::string& faculty) const {
+        RepositoryLock::ReadGuard guard(lock_);
+        return facultyIndex_.count(faculty);
+    }
+    size_t countByStatus(const std::string& status) const {
+        RepositoryLock::ReadGuard guard(lock_);
+        return statusIndex_.count(status);
+    }
+    size_t countByProgram(const std::string& program) const {
+        RepositoryLock::ReadGuard guard(lock_);
+        return programIndex_.count(program);
+    }
+    size_t countByCourse(const std::string& course) const {
+        RepositoryLock::ReadGuard guard(lock_);
+        return courseIndex_.count(course);
+    }
+
     void setValidator(StudentValidator* validator) {
+        RepositoryLock::WriteGuard guard(lock_);
         delete validator_;
         validator_ = validator;
+        if (revalidatePending_ && validator_ != nullptr) {
+            revalidateLoadedStudents(); // Dữ liệu được nạp trước khi có validator
+        }
+    }
+
+    // Kiểm tra `student` bằng validator của repository (như addStudent). Lấy khóa ghi vì
+    // validator không dùng được từ nhiều luồng cùng lúc.
+    bool validate(const Student& student) {
+        RepositoryLock::WriteGuard guard(lock_);
+        return validator_ != nullptr && validator_->isValid(student);
     }
 
     // Method to get all students as a vector of vectors of strings
     std::vector<std::vector<std::string>> getAllStudentsAsStrings() const {
+        RepositoryLock::ReadGuard guard(lock_);
         std::vector<std::vector<std::string>> studentStrings;
-        for (const auto& student : students_) {
-            std::vector<std::string> studentData;
-            studentData.push_back(student.getId());
-            studentData.push_back(student.getName());
-            studentData.push_back(student.getDob());
-            studentData.push_back(student.getGender());
-            studentData.push_back(student.getFaculty());
-            studentData.push_back(student.getCourse());
-            studentData.push_back(student.getProgram());
-            studentData.push_back(student.getAddress());
-            studentData.push_back(student.getEmail());
-            studentData.push_back(student.getPhone());
-            studentData.push_back(student.getStatus());
-            studentStrings.push_back(studentData);
+        for (const StudentPtr& row : students_) {
+            studentStrings.push_back(studentRecord(*row));
         }
         return studentStrings;
     }
 
+    // 11 trường của `student` theo thứ tự của getAllStudentsAsStrings (và isValidRecord)
+    static std::vector<std::string> studentRecord(const Student& student) {
+        return {student.getId(), student.getName(), student.getDob(), student.getGender(), student.getFaculty(),
+                student.getCourse(), student.getProgram(), student.getAddress(), student.getEmail(),
+                student.getPhone(), student.getStatus()};
+    }
+
+    using RecordSink = std::function<void(const std::vector<std::string>&)>;
+
+    // Nhập hàng loạt theo đường ống ba tầng:
+    //   - đọc: `produce` chạy trên một luồng riêng và đưa từng bản ghi (11 trường theo thứ tự
+    //     của getAllStudentsAsStrings, có thể thêm creationTime ISO 8601 ở trường thứ 12) vào
+    //     sink; bản ghi được gom thành lô;
+    //   - kiểm tra: các lô được kiểm tra song song trên ThreadPool (isValidRecord);
+    //   - ghi: luồng gọi hàm nhận các lô theo đúng thứ tự gửi, bỏ qua MSSV trùng, thêm sinh
+    //     viên và báo lỗi theo thứ tự đầu vào.
+    // Số lô đang xử lý bị giới hạn nên bộ nhớ không tăng theo kích thước file. Hàm không lưu
+    // dữ liệu (xem importInBatch). Trả về số bản ghi bị bỏ qua.
+    size_t importStudentRecords(const std::function<void(const RecordSink&)>& produce) {
+        RepositoryLock::WriteGuard guard(lock_);
+        struct Batch {
+            size_t firstRow = 0;
+            std::vector<std::vector<std::string>> records;
+            std::vector<std::string> errors; // Rỗng: bản ghi hợp lệ
+        };
+        if (validator_ == nullptr) {
+            std::cerr << "Validator chưa được thiết lập!\n";
+            return 0;
+        }
+        ThreadPool pool(static_cast<size_t>(std::max(0, ConfigManager::getInstance().getImportThreads())));
+        const size_t maxInFlight = pool.size() * 4;
+        validator_->prepareRecordValidation();
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<std::future<Batch>> inFlight;
+        bool produced = false;
+        bool cancelled = false; // Tầng ghi gặp lỗi: luồng đọc dừng lại, bỏ các lô còn lại
+        std::exception_ptr readerError;
+
+        std::thread reader([&] {
+            Batch batch;
+            size_t rows = 0;
+            auto submit = [&] {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return inFlight.size() < maxInFlight || cancelled; });
+                if (cancelled) {
+                    throw ImportCancelled();
+                }
+                inFlight.push_back(pool.submit([this, work = std::move(batch)]() mutable {
+                    work.errors.resize(work.records.size());
+                    for (size_t i = 0; i < work.records.size(); ++i) {
+                        validator_->isValidRecord(work.records[i], work.errors[i]);
+                    }
+                    return std::move(work);
+                }));
+                changed.notify_all();
+                batch = Batch();
+                batch.firstRow = rows;
+            };
+            try {
+                produce([&](const std::vector<std::string>& record) {
+                    batch.records.push_back(record);
+                    ++rows;
+                    if (batch.records.size() == kImportBatchSize) {
+                        submit();
+                    }
+                });
+            } catch (const ImportCancelled&) {
+                batch.records.clear();
+            } catch (...) {
+                readerError = std::current_exception();
+            }
+            try {
+                if (!batch.records.empty()) {
+                    submit(); // Kể cả khi nguồn lỗi: các bản ghi đã đọc vẫn được thêm
+                }
+            } catch (const ImportCancelled&) {
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            produced = true;
+            changed.notify_all();
+        });
+
+        size_t imported = 0;
+        size_t skipped = 0;
+        try {
+            for (;;) {
+                std::future<Batch> next;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return !inFlight.empty() || produced; });
+                    if (inFlight.empty()) {
+                        break;
+                    }
+                    next = std::move(inFlight.front());
+                    inFlight.pop_front();
+                }
+                changed.notify_all();
+                Batch batch = next.get();
+                for (size_t i = 0; i < batch.records.size(); ++i) {
+                    if (commitImportedRecord(batch.records[i], batch.errors[i], batch.firstRow + i + 1)) {
+                        ++imported;
+                    } else {
+                        ++skipped;
+                    }
+                }
+            }
+        } catch (...) {
+            // Hủy std::thread còn joinable sẽ gọi std::terminate: đánh thức luồng đọc rồi chờ nó
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                cancelled = true;
+            }
+            changed.notify_all();
+            reader.join();
+            throw;
+        }
+        reader.join();
+        if (readerError) {
+            std::rethrow_exception(readerError);
+        }
+        Logger::getInstance().log("Imported " + std::to_string(imported) + " students, skipped " +
+                                  std::to_string(skipped) + ".");
+        return skipped;
+    }
+
     // Method to import students from a vector of vectors of strings
     void importStudentsFromStrings(const std::vector<std::vector<std::string>>& studentStrings) {
-        bool flag = true;
-        for (const auto& studentData : studentStrings) {
-            if (studentData.size() == 11) {
-                Student newStudent(
-                    studentData[0],  // id
-                    studentData[1],  // name
-                    studentData[2],  // dob
-                    studentData[3],  // gender
-                    studentData[4],  // faculty
-                    studentData[5],  // course
-                    studentData[6],  // program
-                    studentData[7],  // address
-                    studentData[8],  // email
-                    studentData[9],  // phone
-                    studentData[10] // status
-                );
-
-                if (validator_->isValid(newStudent)) {
-                    students_.push_back(newStudent);
-                } else {
-                    flag = false;
-                    std::cout << "Thông tin sinh viên không hợp lệ: " << studentData[0] << std::endl;
-                }
-            } else {
-                std::cout << "Dữ liệu không hợp lệ, bỏ qua sinh viên." << std::endl;
+        bool opened = true;
+        importInBatch([&](const RecordSink& sink) {
+            for (const auto& studentData : studentStrings) {
+                sink(studentData);
             }
+        }, opened);
+    }
+
+    // Nhập file CSV theo luồng qua đường ống nhập hàng loạt; false nếu không mở được file
+    bool importStudentsFromCSV(const std::string& filename) {
+        RecordIO recordIO;
+        bool opened = true;
+        importInBatch([&](const RecordSink& sink) {
+            opened = recordIO.importFromCSV(filename, sink);
+        }, opened);
+        return opened;
+    }
+
+    //-----------------------------------------------------------------------
+    // Batch (giao dịch)
+    //-----------------------------------------------------------------------
+
+    // Giữa beginBatch() và commit(), các thay đổi (thêm/sửa/xóa sinh viên, đổi tên, danh sách
+    // khoa/tình trạng/chương trình) chỉ nằm trong bộ nhớ; mỗi thay đổi vẫn được kiểm tra ngay
+    // trên trạng thái đã gồm các thay đổi trước đó của batch. commit() lưu tất cả một lần: ở
+    // chế độ journal, toàn bộ batch là một bản ghi nhật ký nên được áp dụng đủ hoặc không gì
+    // cả khi nạp lại. rollback() bỏ batch, đưa dữ liệu trong bộ nhớ về trạng thái trước batch.
+    // Batch lồng nhau được gộp vào batch ngoài cùng.
+    //
+    // Batch giữ khóa ghi từ beginBatch() đến commit()/rollback() ngoài cùng: luồng khác không
+    // đọc được trạng thái dở dang của batch, cũng không chen thay đổi của mình vào batch.
+    // Vì vậy chỉ luồng đã mở batch được gọi commit()/rollback().
+    //
+    // rollback() không đọc lại file: batch ghi nhận cách hoàn tác từng thay đổi trong bộ nhớ
+    // (bản ghi cũ của sinh viên là bất biến nên chỉ cần giữ con trỏ) và bản sao các danh sách.
+    void beginBatch() {
+        lock_.lock();
+        if (++batchDepth_ > 1) {
+            return;
         }
-        if (flag == true) std::cout << "Nhập dữ liệu thành công" << std::endl;
-        saveStudentDataToFile();
+        batchLists_ = {faculties_, statuses_, programs_};
+    }
+
+    bool commit() {
+        RepositoryLock::WriteGuard guard(lock_);
+        if (batchDepth_ == 0) {
+            return false;
+        }
+        lock_.unlock(); // Khóa của beginBatch() tương ứng; `guard` vẫn giữ khóa đến hết hàm
+        if (--batchDepth_ > 0) {
+            return true;
+        }
+        if (batchSnapshot_) {
+            saveStudentDataToFile(); // Batch quá lớn cho một bản ghi nhật ký: ghi snapshot
+        } else if (!stagedJournal_.empty()) {
+            size_t operations = stagedJournal_.size();
+            journal_.append({{"op", "batch"}, {"ops", std::move(stagedJournal_)}});
+            persistChanges();
+            Logger::getInstance().log("Committed batch of " + std::to_string(operations) + " changes.");
+        } else if (studentsDirty_) {
+            persistChanges();
+        }
+        for (const std::string& filename : dirtyLists_) {
+            scheduleListSave(filename, listData(filename));
+        }
+        resetBatch();
+        return true;
+    }
+
+    void rollback() {
+        RepositoryLock::WriteGuard guard(lock_);
+        if (batchDepth_ == 0) {
+            return;
+        }
+        for (; batchDepth_ > 0; --batchDepth_) {
+            lock_.unlock(); // Khóa của các lần beginBatch()
+        }
+        // batchDepth_ đã về 0 nên các bước hoàn tác không tự ghi nhận lại
+        bool renamed = false;
+        for (auto entry = undoLog_.rbegin(); entry != undoLog_.rend(); ++entry) {
+            renamed |= entry->kind == UndoEntry::Rename;
+            undo(*entry);
+        }
+        faculties_ = std::move(batchLists_[0]);
+        statuses_ = std::move(batchLists_[1]);
+        programs_ = std::move(batchLists_[2]);
+        listRevision_.fetch_add(1);
+        resetBatch();
+        if (renamed && !journal_.isOpen()) {
+            // Lần ghi nền đang tuần tự hóa có thể đã đọc tên mới từ từ điển: ghi lại
+            scheduleStudentSave();
+        }
+        Logger::getInstance().log("Rolled back batch.");
+    }
+
+    // Luồng hiện tại đang mở batch
+    bool inBatch() const { return lock_.ownedByCurrentThread() && batchDepth_ > 0; }
+
+    // Mở batch trong một phạm vi: commit() phải được gọi tường minh, nếu phạm vi kết thúc
+    // trước đó (kể cả do ngoại lệ) thì batch bị rollback().
+    class BatchGuard {
+    public:
+        explicit BatchGuard(StudentRepository& repo) : repo_(repo) { repo_.beginBatch(); }
+        ~BatchGuard() {
+            if (!committed_) {
+                repo_.rollback();
+            }
+        }
+        BatchGuard(const BatchGuard&) = delete;
+        BatchGuard& operator=(const BatchGuard&) = delete;
+
+        bool commit() {
+            committed_ = true;
+            return repo_.commit();
+        }
+
+    private:
+        StudentRepository& repo_;
+        bool committed_ = false;
+    };
+
+    // Các thay đổi ngoài journal được ghi nền (xem PersistenceScheduler); flush() ghi ngay
+    // mọi file đang chờ và đợi ghi xong, ví dụ trước khi thoát hoặc đọc trực tiếp các file.
+    // Không gọi được khi đang giữ khóa ghi (ví dụ trong batch): lần ghi nền cần khóa đọc.
+    void flush() {
+        if (lock_.ownedByCurrentThread()) {
+            throw std::logic_error("StudentRepository::flush() called while holding the write lock");
+        }
+        persistence_.flush();
+    }
+
+    // Xuất mỗi sinh viên thành một dòng JSON (NDJSON, cùng đối tượng như trong students.json).
+    // Từng dòng được ghi ngay, không dựng cả mảng trong bộ nhớ.
+    bool exportStudentsToNDJSON(const std::string& filename) const {
+        RepositoryLock::ReadGuard guard(lock_);
+        NDJSONWriter writer;
+        if (!writer.open(filename)) {
+            return false;
+        }
+        for (const StudentPtr& student : students_) {
+            writer.write(student->toJson());
+        }
+        if (!writer.close()) {
+            std::cerr << "Error: Could not write NDJSON file: " << filename << std::endl;
+            return false;
+        }
+        Logger::getInstance().log("Exported " + std::to_string(writer.count()) + " students to NDJSON: " + filename);
+        return true;
+    }
+
+    // Nhập file NDJSON: mỗi dòng là một đối tượng sinh viên (các khóa như trong students.json,
+    // đổi thành trường như khi nạp students.json, kể cả creationTime), qua đường ống nhập hàng
+    // loạt. File được đọc theo luồng nên không phụ thuộc kích thước file.
+    bool importStudentsFromNDJSON(const std::string& filename) {
+        RecordIO recordIO;
+        bool opened = true;
+        importInBatch([&](const RecordSink& sink) {
+            std::vector<std::string> studentData;
+            opened = recordIO.importFromNDJSON(filename, [&](const json& record) {
+                studentFieldsFromJson(record, studentData); // Bản ghi rỗng: bị tầng kiểm tra từ chối
+                sink(studentData);
+            });
+        }, opened);
+        return opened;
     }
 
     ~StudentRepository() {
         delete validator_;
     }
 
+    // Không gọi được trong batch: rollback() không hoàn tác được việc nạp lại.
     void loadStudentDataFromFile() {
-        std::ifstream file(studentFilename_);
-        students_.clear();
-        if (file.is_open()) {
-            json j;
-            file >> j;
-            for (auto& item : j) {
-                students_.push_back(Student::fromJson(item));
-            }
-            file.close();
-            Logger::getInstance().log("Loaded student data from file.");
+        RepositoryLock::WriteGuard guard(lock_);
+        if (batchDepth_ > 0) {
+            throw std::logic_error("StudentRepository::loadStudentDataFromFile() called inside a batch");
         }
-        else {
-            std::cout << "Không thể mở file để đọc dữ liệu. Tạo file mới.\n";
-            Logger::getInstance().log("Could not open file to load data. Creating new file.");
+        // File phải chứa mọi thay đổi đã lưu trước khi đọc lại. Ghi trực tiếp thay vì
+        // persistence_.flush(): tác vụ ghi nền cần khóa đọc mà luồng này đang giữ.
+        if (studentSavePending()) {
+            saveStudentDataToFile();
+        }
+        applyBackgroundSave();
+        clearStudentData();
+        revalidatePending_ = false;
+        if (useBinarySnapshot()) {
+            loadBinarySnapshot();
+        } else {
+            loadJsonSnapshot();
+        }
+        replayJournal();
+        if (revalidatePending_ && validator_ != nullptr) {
+            revalidateLoadedStudents();
+        }
+        loadedStamp_ = currentDataStamp();
+        loadedHash_ = hashDataFiles();
+        loadedHashValid_ = true;
+    }
+
+    // Chỉ nạp lại dữ liệu khi students.json/nhật ký bị thay đổi từ bên ngoài.
+    // So sánh mtime/kích thước trước; nếu khác thì so sánh hash nội dung.
+    bool reloadIfChanged() {
+        RepositoryLock::WriteGuard guard(lock_);
+        if (inBatch() || studentSavePending()) {
+            return false; // Không ghi đè các thay đổi chưa commit hoặc chưa ghi xong
+        }
+        applyBackgroundSave();
+        DataStamp current = currentDataStamp();
+        if (current == loadedStamp_) {
+            return false;
+        }
+        if (loadedHashValid_ && hashDataFiles() == loadedHash_) {
+            loadedStamp_ = current; // Chỉ đổi mtime (ví dụ: touch), nội dung giữ nguyên
+            return false;
         }
+        loadStudentDataFromFile();
+        Logger::getInstance().log("Reloaded student data after external change.");
+        return true;
     }
 
     void saveStudentDataToFile() {
-        json j = json::array();
-        for (const auto& student : students_) {
-            j.push_back(student.toJson());
+        RepositoryLock::WriteGuard guard(lock_);
+        // Không chờ tác vụ ghi nền (nó cần khóa đọc): studentsSaved_ khiến tác vụ đang chờ
+        // không ghi đè bản cũ hơn lên lần ghi này (xem installStudentFile)
+        applyBackgroundSave();
+        if (journal_.damaged()) {
+            Logger::getInstance().log("Student data not saved: journal is damaged.", LogLevel::Error);
+            return; // Dữ liệu trong bộ nhớ thiếu phần nhật ký chưa nạp được
         }
-        std::ofstream file(studentFilename_);
-        file << std::setw(4) << j << std::endl;
-        file.close();
+        const uint64_t version = studentsVersion_.load();
+        const bool binary = useBinarySnapshot();
+        const std::string& filename = dataFilename();
+        std::string content = binary ? encodeStudentSnapshot(students_)
+                                     : studentsJson(students_, ConfigManager::getInstance().getJsonOutputStyle());
+        FileStamp stamp;
+        if (!installStudentFile(filename, filename + ".tmp", content, version, true, &stamp)) {
+            if (binary) {
+                Logger::getInstance().log("Failed to save binary snapshot.", LogLevel::Error);
+            }
+            return; // File cũ và nhật ký vẫn nguyên vẹn
+        }
+        // Snapshot mới đã bao gồm mọi thay đổi trong nhật ký
+        journal_.reset();
+        markDataWritten();
+        if (binary) {
+            Logger::getInstance().log("Saved student data to binary snapshot.");
+            return;
+        }
+        // Nhật ký vừa được làm rỗng nên hash chỉ phụ thuộc nội dung vừa ghi
+        loadedHash_ = hashFileEnd(hashFileEnd(hashBytes(kFnvOffset, content.data(), content.size())));
+        loadedHashValid_ = true;
         Logger::getInstance().log("Saved student data to file.");
     }
 
+    // Đổi định dạng lưu trữ chính và ghi dữ liệu hiện tại theo định dạng mới
+    void setStorageFormat(const std::string& format) {
+        RepositoryLock::WriteGuard guard(lock_);
+        ConfigManager::getInstance().setStorageFormat(format);
+        ConfigManager::getInstance().saveConfig();
+        saveStudentDataToFile();
+        std::cout << "Dữ liệu sinh viên được lưu tại: " << dataFilename() << "\n";
+    }
+
+    // Đổi kiểu ghi JSON và ghi lại các file dữ liệu theo kiểu mới
+    void setJsonOutputStyle(JsonOutputStyle style) {
+        RepositoryLock::WriteGuard guard(lock_);
+        ConfigManager::getInstance().setJsonOutputStyle(style);
+        ConfigManager::getInstance().saveConfig();
+        saveStudentDataToFile();
+        saveDataToFile(facultyFilename_, faculties_);
+        saveDataToFile(statusFilename_, statuses_);
+        saveDataToFile(programFilename_, programs_);
+        std::cout << "Các file JSON được ghi theo kiểu: " << jsonOutputStyleName(style) << "\n";
+    }
+
+    // Tóm tắt danh sách: tổng số sinh viên và số lượng theo tình trạng
+    void displaySummary() const {
+        RepositoryLock::ReadGuard guard(lock_);
+        std::cout << "\n--- Tổng quan sinh viên ---" << std::endl;
+        std::cout << "Tổng số sinh viên: " << students_.size() << std::endl;
+        for (const auto& entry : statusIndex_.keyCounts()) {
+            std::cout << "  " << entry.first << ": " << entry.second << std::endl;
+        }
+    }
+
+    size_t getStudentCount() const {
+        RepositoryLock::ReadGuard guard(lock_);
+        return students_.size();
+    }
+
+    // Hiển thị trang `page` (bắt đầu từ 1) gồm tối đa `pageSize` sinh viên
+    void displayStudentsPage(size_t page, size_t pageSize) const {
+        RepositoryLock::ReadGuard guard(lock_);
+        size_t pageCount = (students_.size() + pageSize - 1) / pageSize;
+        std::cout << "\n--- Danh sách sinh viên (trang " << page << "/" << pageCount << ") ---" << std::endl;
+        if (students_.empty()) {
+            std::cout << "Danh sách trống.\n";
+            return;
+        }
+        size_t begin = (page - 1) * pageSize;
+        size_t end = std::min(begin + pageSize, students_.size());
+        for (size_t i = begin; i < end; ++i) {
+            students_[i]->displayInfo();
+            std::cout << "----------\n";
+        }
+    }
+
     void displayAllStudents() {
+        RepositoryLock::ReadGuard guard(lock_);
         std::cout << "\n--- Danh sách sinh viên ---" << std::endl;
         if (students_.empty()) {
             std::cout << "Danh sách trống.\n";
             return;
         }
-        for (const Student& student : students_) {
-            student.displayInfo();
+        for (const StudentPtr& student : students_) {
+            student->displayInfo();
             std::cout << "----------\n";
         }
     }
@@ -405,46 +1061,56 @@ public:
     //-----------------------------------------------------------------------
 
     void addFaculty(const std::string& faculty) {
+        RepositoryLock::WriteGuard guard(lock_);
         if (!isValidFaculty(faculty)) {
             faculties_.push_back(faculty);
             std::cout << "Đã thêm khoa mới: " << faculty << ".\n";
-            saveDataToFile(facultyFilename_, faculties_);
+            persistList(facultyFilename_, faculties_);
         } else {
             std::cout << "Khoa này đã tồn tại.\n";
         }
     }
 
     void renameFaculty(const std::string& oldFaculty, const std::string& newFaculty) {
+        RepositoryLock::WriteGuard guard(lock_);
         if (isValidFaculty(newFaculty)) {
             std::cout << "Tên khoa mới đã tồn tại.\n";
             return;
         }
 
-        bool found = false;
-        for (auto& student : students_) {
-            if (student.getFaculty() == oldFaculty) {
-                student.setFaculty(newFaculty);
-                found = true;
-            }
-        }
-
+        bool found = facultyIndex_.count(oldFaculty) > 0;
         if (found) {
+            BatchGuard batch(*this); // Dữ liệu sinh viên và danh sách khoa được lưu cùng lúc
+            renameFieldValue("faculty", oldFaculty, newFaculty);
+            recordRename("faculty", oldFaculty, newFaculty);
             // Update the faculty list
             std::replace(faculties_.begin(), faculties_.end(), oldFaculty, newFaculty);
             std::cout << "Đã đổi tên khoa " << oldFaculty << " thành " << newFaculty << ".\n";
 
-            saveStudentDataToFile(); // Update student data because faculty has been changed
-            saveDataToFile(facultyFilename_, faculties_);
+            persistChanges(); // Update student data because faculty has been changed
+            persistList(facultyFilename_, faculties_);
+            batch.commit();
         } else {
             std::cout << "Không tìm thấy khoa " << oldFaculty << ".\n";
         }
     }
 
+    // Tăng mỗi khi danh sách khoa/tình trạng/chương trình đổi (kể cả khi rollback), để
+    // validator chỉ chụp lại danh sách khi cần
+    unsigned long getListRevision() const { return listRevision_.load(); }
+
+    std::vector<std::string> getFaculties() const {
+        RepositoryLock::ReadGuard guard(lock_);
+        return faculties_;
+    }
+
     bool isValidFaculty(const std::string& faculty) const {
+        RepositoryLock::ReadGuard guard(lock_);
         return std::find(faculties_.begin(), faculties_.end(), faculty) != faculties_.end();
     }
 
     void displayFaculties() const {
+        RepositoryLock::ReadGuard guard(lock_);
         std::cout << "\n--- Danh sách các Khoa ---" << std::endl;
         for (const auto& faculty : faculties_) {
             std::cout << faculty << std::endl;
@@ -455,45 +1121,51 @@ public:
     // Status Management
     //-----------------------------------------------------------------------
     void addStatus(const std::string& status) {
+        RepositoryLock::WriteGuard guard(lock_);
         if (!isValidStatus(status)) {
             statuses_.push_back(status);
             std::cout << "Đã thêm tình trạng mới: " << status << ".\n";
-            saveDataToFile(statusFilename_, statuses_);
+            persistList(statusFilename_, statuses_);
         } else {
             std::cout << "Tình trạng này đã tồn tại.\n";
         }
     }
 
     void renameStatus(const std::string& oldStatus, const std::string& newStatus) {
+        RepositoryLock::WriteGuard guard(lock_);
         if (isValidStatus(newStatus)) {
             std::cout << "Tên tình trạng mới đã tồn tại.\n";
             return;
         }
 
-        bool found = false;
-        for (auto& student : students_) {
-            if (student.getStatus() == oldStatus) {
-                student.setStatus(newStatus);
-                found = true;
-            }
-        }
-
+        bool found = statusIndex_.count(oldStatus) > 0;
         if (found) {
+            BatchGuard batch(*this);
+            renameFieldValue("status", oldStatus, newStatus);
+            recordRename("status", oldStatus, newStatus);
             // Update the status list
             std::replace(statuses_.begin(), statuses_.end(), oldStatus, newStatus);
             std::cout << "Đã đổi tên tình trạng " << oldStatus << " thành " << newStatus << ".\n";
-            saveStudentDataToFile(); // Update student data because status has been changed
-            saveDataToFile(statusFilename_, statuses_);
+            persistChanges(); // Update student data because status has been changed
+            persistList(statusFilename_, statuses_);
+            batch.commit();
         } else {
             std::cout << "Không tìm thấy tình trạng " << oldStatus << ".\n";
         }
     }
 
+    std::vector<std::string> getStatuses() const {
+        RepositoryLock::ReadGuard guard(lock_);
+        return statuses_;
+    }
+
     bool isValidStatus(const std::string& status) const {
+        RepositoryLock::ReadGuard guard(lock_);
         return std::find(statuses_.begin(), statuses_.end(), status) != statuses_.end();
     }
 
     void displayStatuses() const {
+        RepositoryLock::ReadGuard guard(lock_);
         std::cout << "\n--- Danh sách các Tình trạng ---" << std::endl;
         for (const auto& status : statuses_) {
             std::cout << status << std::endl;
@@ -504,45 +1176,51 @@ public:
     // Program Management
     //-----------------------------------------------------------------------
     void addProgram(const std::string& program) {
+        RepositoryLock::WriteGuard guard(lock_);
         if (!isValidProgram(program)) {
             programs_.push_back(program);
             std::cout << "Đã thêm chương trình mới: " << program << ".\n";
-            saveDataToFile(programFilename_, programs_);
+            persistList(programFilename_, programs_);
         } else {
             std::cout << "Chương trình này đã tồn tại.\n";
         }
     }
 
     void renameProgram(const std::string& oldProgram, const std::string& newProgram) {
+        RepositoryLock::WriteGuard guard(lock_);
         if (isValidProgram(newProgram)) {
             std::cout << "Tên chương trình mới đã tồn tại.\n";
             return;
         }
 
-        bool found = false;
-        for (auto& student : students_) {
-            if (student.getProgram() == oldProgram) {
-                student.setProgram(newProgram);
-                found = true;
-            }
-
-        }
-
+        bool found = programIndex_.count(oldProgram) > 0;
         if (found) {
+            BatchGuard batch(*this);
+            renameFieldValue("program", oldProgram, newProgram);
+            recordRename("program", oldProgram, newProgram);
             // Update the program list
             std::replace(programs_.begin(), programs_.end(), oldProgram, newProgram);
             std::cout << "Đã đổi tên chương trình " << oldProgram << " thành " << newProgram << ".\n";
-            saveStudentDataToFile(); // Update student data because program has been changed
-            saveDataToFile(programFilename_, programs_);        } else {
+            persistChanges(); // Update student data because program has been changed
+            persistList(programFilename_, programs_);
+            batch.commit();
+        } else {
             std::cout << "Không tìm thấy chương trình " << oldProgram << ".\n";
         }
     }
 
+    std::vector<std::string> getPrograms() const {
+        RepositoryLock::ReadGuard guard(lock_);
+        return programs_;
+    }
+
     bool isValidProgram(const std::string& program) const {
+        RepositoryLock::ReadGuard guard(lock_);
         return std::find(programs_.begin(), programs_.end(), program) != programs_.end();
     }
 
     void displayPrograms() const {
+        RepositoryLock::ReadGuard guard(lock_);
         std::cout << "\n--- Danh sách các Chương trình ---" << std::endl;
         for (const auto& program : programs_) {
             std::cout << program << std::endl;
@@ -550,7 +1228,10 @@ public:
     }
 
 private:
-    StudentRepository() : validator_(nullptr) {
+    StudentRepository() : validator_(nullptr), journal_(journalFilename_) {
+        if (ConfigManager::getInstance().getJournalMode()) {
+            journal_.open(static_cast<size_t>(ConfigManager::getInstance().getJournalGroupSize()));
+        }
         loadStudentDataFromFile();
         loadDataFromFile(facultyFilename_, faculties_);
         loadDataFromFile(statusFilename_, statuses_);
@@ -561,138 +1242,1218 @@ private:
 
     void loadDataFromFile(const std::string& filename, std::vector<std::string>& data) {
         std::ifstream file(filename);
-        if (file.is_open()) {
-            json j;
-            file >> j;
-            data = j.get<std::vector<std::string>>();
-        } else {
-                std::cout << "Không thể mở file để đọc dữ liệu " << filename << ". Tạo file mới.\n";
+        if (!file.is_open()) {
+            std::cout << "Không thể mở file để đọc dữ liệu " << filename << ". Tạo file mới.\n";
+            return;
+        }
+        json values = parseJsonRecords(file);
+        if (verifyFileDigest(filename)) {
+            data = values.get<std::vector<std::string>>();
+            return;
+        }
+        // Không khớp tóm tắt: chỉ nhận các chuỗi không rỗng, không trùng
+        data.clear();
+        size_t skipped = 0;
+        for (const json& value : values) {
+            if (!value.is_string() || value.get_ref<const std::string&>().empty() ||
+                std::find(data.begin(), data.end(), value.get_ref<const std::string&>()) != data.end()) {
+                ++skipped;
+                continue;
+            }
+            data.push_back(value.get<std::string>());
+        }
+        if (skipped > 0) {
+            std::cout << "Cảnh báo: bỏ qua " << skipped << " giá trị không hợp lệ trong " << filename << ".\n";
+            Logger::getInstance().log("Skipped " + std::to_string(skipped) + " invalid values in " + filename);
         }
     }
 
-
-    // Helper function to save data to file
-
-    void saveDataToFile(const std::string& filename, const std::vector<std::string>& data) {
-        json j = data;
-        std::ofstream file(filename);
-        file << std::setw(4) << j << std::endl;
-        file.close();
+    // students.json vừa nạp không khớp tóm tắt: kiểm tra lại từng sinh viên theo quy tắc hiện
+    // tại và báo các bản ghi không hợp lệ. Các bản ghi vẫn được giữ để không mất dữ liệu.
+    void revalidateLoadedStudents() {
+        revalidatePending_ = false;
+        validator_->prepareRecordValidation();
+        size_t invalid = 0;
+        std::string error;
+        for (const StudentPtr& row : students_) {
+            if (!validator_->isValidRecord(studentRecord(*row), error)) {
+                ++invalid;
+                Logger::getInstance().log("Invalid student " + row->getId() + " in " + studentFilename_ + ": " + error);
+            }
+        }
+        if (invalid > 0) {
+            std::cout << "Cảnh báo: " << invalid << " sinh viên trong " << studentFilename_
+                      << " không hợp lệ theo quy tắc hiện tại (xem log).\n";
+        }
     }
 
-    std::vector<Student> students_;
-    StudentValidator* validator_;
-    const std::string studentFilename_ = "students.json";
-
-    // Filenames for Faculty, Status, and Program
-
-    const std::string facultyFilename_ = "faculties.json";
-    const std::string statusFilename_ = "statuses.json";
-    const std::string programFilename_ = "programs.json";
-
-    // Data Members for Faculty, Status, and Program
-    std::vector<std::string> faculties_ = {"FL", "FBE", "FJPN", "FFR"};  // Initial values
-    std::vector<std::string> statuses_ = {"Active", "Graduated", "Leave", "Absent"}; // Initial values
-    std::vector<std::string> programs_ = {"Advanced Program", "Formal Program", "High Quality Program"}; // Initial values
-};
 
+    // Số bản ghi mỗi lô của đường ống nhập hàng loạt
+    static constexpr size_t kImportBatchSize = 2048;
 
-class ConcreteStudentValidator : public StudentValidator {
-public:
-    ConcreteStudentValidator(class StudentRepository* repo) : repo_(repo) {}
+    // Ném trong luồng đọc của đường ống nhập khi tầng ghi đã bỏ cuộc
+    struct ImportCancelled {};
 
-    bool isValid(const Student& student) override {
-        if (ConfigManager::getInstance().getEnforceValidation()) {
-            if (!isValidEmail(student.getEmail())) {
-                std::cout << "Email không hợp lệ.\n";
-                return false;
-            }
-            if (!isValidPhone(student.getPhone())) {
-                std::cout << "Số điện thoại không hợp lệ.\n";
-                return false;
-            }
+    // Chạy importStudentRecords trong một batch: lưu một lần ở cuối (nếu `opened`, do nguồn
+    // đặt), hoặc hủy toàn bộ nếu nguồn ném ngoại lệ.
+    void importInBatch(const std::function<void(const RecordSink&)>& produce, const bool& opened) {
+        BatchGuard batch(*this);
+        size_t skipped = importStudentRecords(produce);
+        if (opened && skipped == 0) {
+            std::cout << "Nhập dữ liệu thành công" << std::endl;
         }
+        batch.commit();
+    }
 
-        if (!repo_->isValidFaculty(student.getFaculty())) {
-            std::cout << "Khoa không hợp lệ.\n";
-            return false;
-        }
-        if (!repo_->isValidStatus(student.getStatus())) {
-            std::cout << "Tình trạng sinh viên không hợp lệ.\n";
-            return false;
-        }
-        if (!isValidGender(student.getGender())) {
-            std::cout << "Giới tính không hợp lệ. (Male, Female)\n";
-            return false;
-        }
-        if (!repo_->isValidProgram(student.getProgram())) {
-            std::cout << "Chương trình không hợp lệ. (Advanced Program, Formal Program, High Quality Program)\n";
+    // Tầng ghi của importStudentRecords: bản ghi thứ `row` (đã được kiểm tra, `error` rỗng
+    // nếu hợp lệ) được thêm nếu MSSV chưa có. Trả về false nếu bị bỏ qua.
+    bool commitImportedRecord(const std::vector<std::string>& record, const std::string& error, size_t row) {
+        if (!error.empty()) {
+            std::cout << "Bản ghi " << row << (record.empty() ? "" : " (" + record[0] + ")") << ": " << error
+                      << " Bỏ qua sinh viên." << std::endl;
             return false;
         }
-        if (!isValidCourse(student.getCourse())) {
-            std::cout << "Khóa không hợp lệ. (YYYY)\n";
+        if (isStudentIdExists(record[0])) {
+            std::cout << "Bản ghi " << row << ": MSSV đã tồn tại, bỏ qua sinh viên: " << record[0] << std::endl;
             return false;
         }
-        if (!isValidDOB(student.getDob())) {
-            std::cout << "Ngày sinh không hợp lệ. (DD/MM/YYYY)\n";
-            return false;
+        Student student(record[0], record[1], record[2], record[3], record[4], record[5], record[6], record[7],
+                        record[8], record[9], record[10]);
+        if (record.size() > 11 && !record[11].empty()) {
+            student.setCreationTime(iso8601ToTimePoint(record[11]));
         }
+        recordPut(student);
+        appendStudent(heapRow(std::move(student)));
         return true;
     }
 
-private:
-    // Kiểm tra email: phải kết thúc với đuôi đã cấu hình
-    bool isValidEmail(const std::string& email) {
-        std::string suffix = ConfigManager::getInstance().getEmailSuffix();
-        if (email.size() < suffix.size()) return false;
-        return email.compare(email.size() - suffix.size(), suffix.size(), suffix) == 0;
+    // Thêm sinh viên vào cuối danh sách và ghi nhận vị trí vào chỉ mục MSSV.
+    // Nếu MSSV đã có trong chỉ mục (file dữ liệu bị trùng), bản ghi sau cùng được giữ lại.
+    void appendStudent(StudentPtr row) {
+        auto entry = idIndex_.find(idKey(row->getIdView()));
+        if (entry != idIndex_.end()) {
+            recordUndo({UndoEntry::Replace, entry->second, students_[entry->second]});
+            setRow(entry->second, std::move(row));
+            return;
+        }
+        recordUndo({UndoEntry::Append});
+        pushRow(std::move(row));
+    }
+
+    // Ghi đè sinh viên ở `slot` bằng `updated` (MSSV mới, nếu đổi, đã được kiểm tra là chưa có)
+    void replaceStudent(size_t slot, const Student& updated) {
+        std::string id = students_[slot]->getId();
+        if (updated.getIdView() != id) {
+            recordRemove(id);
+        }
+        recordUndo({UndoEntry::Replace, slot, students_[slot]});
+        setRow(slot, heapRow(Student(updated)));
+        recordPut(updated);
+        persistChanges();
+    }
+
+    // Xóa sinh viên tại vị trí `slot` trong O(1): phần tử cuối được chuyển vào chỗ trống.
+    void eraseSlot(size_t slot) {
+        recordUndo({UndoEntry::Erase, slot, students_[slot]});
+        idIndex_.erase(idKey(students_[slot]->getIdView()));
+        unindexSlot(slot);
+        size_t last = students_.size() - 1;
+        if (slot != last) {
+            relocateSlot(last, slot);
+            students_[slot] = std::move(students_[last]);
+            idIndex_.find(idKey(students_[slot]->getIdView()))->second = slot;
+        }
+        students_.pop_back();
+        columns_.swapRemove(slot);
+    }
+
+    // Thêm `row` vào cuối students_ cùng chỉ mục và kho cột (MSSV chưa có)
+    void pushRow(StudentPtr row) {
+        idIndex_.emplace(row->getId(), students_.size());
+        students_.push_back(std::move(row));
+        columns_.append(*students_.back());
+        indexSlot(students_.size() - 1);
+    }
+
+    // Bỏ sinh viên cuối cùng (ngược với pushRow)
+    void popRow() {
+        size_t last = students_.size() - 1;
+        idIndex_.erase(idKey(students_[last]->getIdView()));
+        unindexSlot(last);
+        students_.pop_back();
+        columns_.swapRemove(last);
+    }
+
+    // Thay sinh viên ở `slot` bằng `row`; nếu khác MSSV thì MSSV mới phải chưa có
+    void setRow(size_t slot, StudentPtr row) {
+        unindexSlot(slot);
+        if (row->getIdView() != students_[slot]->getIdView()) {
+            idIndex_.erase(idKey(students_[slot]->getIdView()));
+            idIndex_.emplace(row->getId(), slot);
+        }
+        students_[slot] = std::move(row);
+        columns_.assign(slot, *students_[slot]);
+        indexSlot(slot);
+    }
+
+    // Khóa để tra idIndex_ từ một view. unordered_map của C++17 chưa tra được bằng
+    // string_view, nên MSSV được chép vào bộ đệm dùng lại (riêng cho mỗi luồng, vì các
+    // luồng đọc tra cùng lúc) thay vì tạo chuỗi tạm mỗi lần.
+    static const std::string& idKey(std::string_view id) {
+        thread_local std::string probe;
+        probe.assign(id.data(), id.size());
+        return probe;
+    }
+
+    // Bản ghi của lần nạp snapshot: cấp phát (cùng các chuỗi) trong arena, được trả lại cả
+    // khối ở lần nạp sau. Chỉ dùng khi nạp: bản ghi bị thay hoặc xóa vẫn chiếm arena.
+    StudentPtr arenaRow(Student&& student) {
+        return std::allocate_shared<Student>(std::pmr::polymorphic_allocator<Student>(arena_.get()),
+                                             std::move(student));
+    }
+
+    // Bản ghi của các thay đổi lúc chạy (thêm, sửa, nhập, nhật ký): trên heap, được giải
+    // phóng khi bị thay hoặc xóa. Chuỗi của `student` phải nằm trên heap.
+    static StudentPtr heapRow(Student&& student) {
+        return std::make_shared<const Student>(std::move(student));
+    }
+
+    //-----------------------------------------------------------------------
+    // Secondary indexes (khoa, tình trạng, chương trình, khóa, họ tên)
+    //-----------------------------------------------------------------------
+
+    void indexSlot(size_t slot) {
+        const Student& student = *students_[slot];
+        facultyIndex_.insert(student.getFaculty(), slot);
+        statusIndex_.insert(student.getStatus(), slot);
+        programIndex_.insert(student.getProgram(), slot);
+        courseIndex_.insert(student.getCourseView(), slot);
+        nameIndex_.insert(slot, student.getNameView());
+        if (fuzzyBuilt_) {
+            idFuzzy_.insert(student.getId(), student.getId());
+            nameFuzzy_.insert(foldName(student.getNameView()), student.getId());
+        }
+    }
+
+    void unindexSlot(size_t slot) {
+        const Student& student = *students_[slot];
+        facultyIndex_.erase(student.getFaculty(), slot);
+        statusIndex_.erase(student.getStatus(), slot);
+        programIndex_.erase(student.getProgram(), slot);
+        courseIndex_.erase(student.getCourseView(), slot);
+        nameIndex_.erase(slot);
+        if (fuzzyBuilt_) {
+            idFuzzy_.erase(student.getId(), student.getId());
+            nameFuzzy_.erase(foldName(student.getNameView()), student.getId());
+        }
+    }
+
+    // Gọi trước khi chuyển students_[from] sang vị trí `to`
+    void relocateSlot(size_t from, size_t to) {
+        const Student& student = *students_[from];
+        facultyIndex_.relocate(student.getFaculty(), from, to);
+        statusIndex_.relocate(student.getStatus(), from, to);
+        programIndex_.relocate(student.getProgram(), from, to);
+        courseIndex_.relocate(student.getCourseView(), from, to);
+        nameIndex_.relocate(from, to);
+    }
+
+    // Khoa, tình trạng và chương trình: các trường renameFieldValue đổi được
+    struct RenamableField {
+        FieldDictionary* dictionary = nullptr;
+        StudentIndex* index = nullptr;
+        void (Student::*set)(std::string_view) = nullptr;
+        uint32_t (Student::*code)() const = nullptr;
+    };
+
+    bool renamableField(const std::string& field, RenamableField& target) {
+        StudentDictionaries& dictionaries = StudentDictionaries::getInstance();
+        if (field == "faculty") {
+            target = {&dictionaries.faculty, &facultyIndex_, &Student::setFaculty, &Student::getFacultyCode};
+        } else if (field == "status") {
+            target = {&dictionaries.status, &statusIndex_, &Student::setStatus, &Student::getStatusCode};
+        } else if (field == "program") {
+            target = {&dictionaries.program, &programIndex_, &Student::setProgram, &Student::getProgramCode};
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // Đổi giá trị `from` thành `to` của trường `field` ("faculty", "status", "program").
+    // Thông thường chỉ cần đổi chuỗi trong từ điển (O(1)); nếu `to` đã có mã riêng thì
+    // thay bản ghi của những sinh viên bị ảnh hưởng (tìm qua chỉ mục).
+    void renameFieldValue(const std::string& field, const std::string& from, const std::string& to) {
+        RenamableField target;
+        if (!renamableField(field, target)) {
+            return;
+        }
+        uint32_t code;
+        if (!target.dictionary->lookup(from, code)) {
+            return;
+        }
+        if (target.dictionary->rename(code, to)) {
+            target.index->renameKey(from, to);
+            recordUndo({UndoEntry::Rename, 0, nullptr, field, from, to, code});
+            return;
+        }
+        setFieldValue(target, target.index->find(from), to);
+    }
+
+    // Thay bản ghi của các sinh viên ở `slots` bằng bản có trường `target` là `value`
+    void setFieldValue(const RenamableField& target, std::vector<size_t> slots, const std::string& value) {
+        // `slots` là bản sao: setRow() sửa chỉ mục
+        for (size_t slot : slots) {
+            Student changed(*students_[slot]);
+            (changed.*target.set)(value);
+            recordUndo({UndoEntry::Replace, slot, students_[slot]});
+            setRow(slot, heapRow(std::move(changed)));
+        }
+    }
+
+    //-----------------------------------------------------------------------
+    // Query execution
+    //-----------------------------------------------------------------------
+
+    // Điều kiện đã chuẩn bị sẵn: mã từ điển, số nguyên hoặc chuỗi đã bỏ dấu được tính một lần
+    struct CompiledPredicate {
+        StudentField field;
+        QueryOp op;
+        std::string value;
+        bool coded = false;     // So sánh bằng mã từ điển
+        uint32_t code = 0;
+        bool codeKnown = false; // Giá trị có trong từ điển
+        bool numeric = false;
+        long long number = 0;
+        std::string folded;     // Cho toán tử ~
+    };
+
+    static FieldDictionary* dictionaryFor(StudentField field) {
+        StudentDictionaries& dictionaries = StudentDictionaries::getInstance();
+        switch (field) {
+            case StudentField::Gender: return &dictionaries.gender;
+            case StudentField::Faculty: return &dictionaries.faculty;
+            case StudentField::Program: return &dictionaries.program;
+            case StudentField::Status: return &dictionaries.status;
+            default: return nullptr;
+        }
+    }
+
+    // Cột mã từ điển của trường `field` trong kho cột
+    const std::vector<uint32_t>& codeColumn(StudentField field) const {
+        switch (field) {
+            case StudentField::Gender: return columns_.gender;
+            case StudentField::Faculty: return columns_.faculty;
+            case StudentField::Program: return columns_.program;
+            default: return columns_.status;
+        }
+    }
+
+    // Giá trị của trường tại vị trí `slot`, đọc thẳng từ bản ghi (không sao chép)
+    std::string_view fieldValue(size_t slot, StudentField field) const {
+        const Student& student = *students_[slot];
+        switch (field) {
+            case StudentField::Id: return student.getIdView();
+            case StudentField::Name: return student.getNameView();
+            case StudentField::Dob: return student.getDobView();
+            case StudentField::Gender: return student.getGender();
+            case StudentField::Faculty: return student.getFaculty();
+            case StudentField::Course: return student.getCourseView();
+            case StudentField::Program: return student.getProgram();
+            case StudentField::Address: return student.getAddressView();
+            case StudentField::Email: return student.getEmailView();
+            case StudentField::Phone: return student.getPhoneView();
+            case StudentField::Status: return student.getStatus();
+        }
+        return student.getIdView();
     }
 
-    std::string escapeRegex(const std::string& str) {
-        std::string escaped;
-        for (char c : str) {
-            if (std::string(".^$|()[]{}*+?\\").find(c) != std::string::npos) {
-                escaped.push_back('\\');
+    const StudentIndex* indexFor(StudentField field) const {
+        switch (field) {
+            case StudentField::Faculty: return &facultyIndex_;
+            case StudentField::Status: return &statusIndex_;
+            case StudentField::Program: return &programIndex_;
+            case StudentField::Course: return &courseIndex_;
+            default: return nullptr;
+        }
+    }
+
+    static bool parseInteger(std::string_view text, long long& value) {
+        if (text.empty() || text.size() > 18) {
+            return false;
+        }
+        value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') {
+                return false;
             }
-            escaped.push_back(c);
+            value = value * 10 + (c - '0');
         }
-        return escaped;
+        return true;
     }
 
-    bool isValidPhone(const std::string& phone) {
-        // Lấy cấu hình phoneRegex từ ConfigManager
-        std::string phonePattern = ConfigManager::getInstance().getPhoneRegex();
-        std::cout << "Cấu hình phoneRegex: " << phonePattern << "\n";
+    // DD/MM/YYYY -> YYYYMMDD để so sánh ngày sinh theo thứ tự thời gian
+    static std::string dateKey(std::string_view dob) {
+        if (dob.size() == 10 && dob[2] == '/' && dob[5] == '/') {
+            return std::string(dob.substr(6, 4)) + std::string(dob.substr(3, 2)) + std::string(dob.substr(0, 2));
+        }
+        return std::string(dob);
+    }
 
-        // Nếu chuỗi không bắt đầu bằng '^', cho rằng đây là chuỗi literal và escape nó
-        if (phonePattern.empty() || phonePattern.front() != '^') {
-            phonePattern = "^" + escapeRegex(phonePattern) + ".*$";
+    // `impossible` được bật khi điều kiện chắc chắn không khớp sinh viên nào
+    static CompiledPredicate compilePredicate(const QueryPredicate& predicate, bool& impossible) {
+        CompiledPredicate compiled;
+        compiled.field = predicate.field;
+        compiled.op = predicate.op;
+        compiled.value = predicate.field == StudentField::Dob ? dateKey(predicate.value) : predicate.value;
+        FieldDictionary* dictionary = dictionaryFor(predicate.field);
+        if (dictionary != nullptr && (predicate.op == QueryOp::Equal || predicate.op == QueryOp::NotEqual)) {
+            compiled.coded = true;
+            compiled.codeKnown = dictionary->lookup(predicate.value, compiled.code);
+            if (!compiled.codeKnown && predicate.op == QueryOp::Equal) {
+                impossible = true;
+            }
+        }
+        compiled.numeric = parseInteger(predicate.value, compiled.number);
+        if (predicate.op == QueryOp::Contains) {
+            compiled.folded = foldName(predicate.value);
         }
+        return compiled;
+    }
 
-        try {
-            std::regex pattern(phonePattern);
-            return std::regex_match(phone, pattern);
-        } catch (std::regex_error& e) {
-            std::cerr << "Regex error: " << e.what() << std::endl;
+    bool matchesPredicate(size_t slot, const CompiledPredicate& predicate) const {
+        if (predicate.coded) {
+            bool equal = predicate.codeKnown && codeColumn(predicate.field)[slot] == predicate.code;
+            return predicate.op == QueryOp::Equal ? equal : !equal;
+        }
+        std::string_view value = fieldValue(slot, predicate.field);
+        int order = 0;
+        switch (predicate.op) {
+            case QueryOp::Equal:
+            case QueryOp::NotEqual: {
+                // Ngày sinh được biên dịch thành YYYYMMDD nên phải so sánh cùng dạng khoá
+                bool equal = predicate.field == StudentField::Dob ? dateKey(value) == predicate.value
+                                                                  : value == predicate.value;
+                return predicate.op == QueryOp::Equal ? equal : !equal;
+            }
+            case QueryOp::Contains:
+                if (predicate.field == StudentField::Name) {
+                    return nameIndex_.matches(slot, predicate.folded, NameMatchMode::Substring);
+                }
+                return foldName(value).find(predicate.folded) != std::string::npos;
+            default:
+                break;
+        }
+        long long number;
+        if (predicate.numeric && parseInteger(value, number)) {
+            order = number < predicate.number ? -1 : number > predicate.number ? 1 : 0;
+        } else if (predicate.field == StudentField::Dob) {
+            order = dateKey(value).compare(predicate.value);
+        } else {
+            order = value.compare(predicate.value);
+        }
+        switch (predicate.op) {
+            case QueryOp::Less: return order < 0;
+            case QueryOp::LessEqual: return order <= 0;
+            case QueryOp::Greater: return order > 0;
+            default: return order >= 0;
+        }
+    }
+
+    // Chọn tập ứng viên nhỏ nhất từ các chỉ mục; false nếu phải duyệt toàn bộ
+    bool selectCandidates(const std::vector<CompiledPredicate>& predicates, std::vector<size_t>& candidates,
+                          std::string& indexName) const {
+        const std::vector<size_t>* best = nullptr;
+        size_t bestSize = students_.size();
+        for (const CompiledPredicate& predicate : predicates) {
+            if (predicate.op != QueryOp::Equal) {
+                continue;
+            }
+            if (predicate.field == StudentField::Id) {
+                auto entry = idIndex_.find(predicate.value);
+                candidates.clear();
+                if (entry != idIndex_.end()) {
+                    candidates.push_back(entry->second);
+                }
+                indexName = "id";
+                return true;
+            }
+            const StudentIndex* index = indexFor(predicate.field);
+            if (index != nullptr && index->count(predicate.value) < bestSize) {
+                best = &index->find(predicate.value);
+                bestSize = best->size();
+                indexName = studentFieldName(predicate.field);
+            }
+        }
+        // Chỉ mục họ tên phải thực thi mới biết kích thước: chỉ dùng khi chưa có tập đủ nhỏ
+        const size_t nameIndexThreshold = 1024;
+        if (bestSize > nameIndexThreshold) {
+            for (const CompiledPredicate& predicate : predicates) {
+                if (predicate.field == StudentField::Name && predicate.op == QueryOp::Contains) {
+                    std::vector<size_t> byName = nameIndex_.search(predicate.value);
+                    if (byName.size() < bestSize) {
+                        candidates.swap(byName);
+                        indexName = "name";
+                        return true;
+                    }
+                }
+            }
+        }
+        if (best == nullptr) {
+            return false;
+        }
+        candidates.assign(best->begin(), best->end());
+        std::sort(candidates.begin(), candidates.end()); // Giữ thứ tự lưu trữ cho OFFSET/LIMIT
+        return true;
+    }
+
+    void clearStudentData() {
+        students_.clear();
+        // Toàn bộ chuỗi của dữ liệu cũ được trả lại cùng lúc, khi lần ghi nền cuối cùng còn
+        // dùng các bản ghi cũ (nếu có) xong việc
+        arena_ = newArena();
+        columns_.clear();
+        idIndex_.clear();
+        clearFieldIndexes();
+    }
+
+    void clearFieldIndexes() {
+        facultyIndex_.clear();
+        statusIndex_.clear();
+        programIndex_.clear();
+        courseIndex_.clear();
+        nameIndex_.clear();
+        idFuzzy_.clear();
+        nameFuzzy_.clear();
+        fuzzyBuilt_ = false;
+    }
+
+    // BK-tree tìm gần đúng chỉ được dựng ở lần tìm đầu tiên (tốn vài giây với 1 triệu
+    // sinh viên), sau đó được cập nhật cùng các chỉ mục khác. Gọi khi giữ khóa đọc: nhiều
+    // luồng đọc có thể cùng gọi nên việc dựng được tuần tự hóa bằng fuzzyMutex_.
+    void buildFuzzyIndexes() const {
+        if (fuzzyBuilt_.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(fuzzyMutex_);
+        if (fuzzyBuilt_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        for (const StudentPtr& student : students_) {
+            idFuzzy_.insert(student->getId(), student->getId());
+            nameFuzzy_.insert(foldName(student->getNameView()), student->getId());
+        }
+        fuzzyBuilt_.store(true, std::memory_order_release);
+        Logger::getInstance().log("Built fuzzy search index for " + std::to_string(students_.size()) + " students.");
+    }
+
+    //-----------------------------------------------------------------------
+    // Journal
+    //-----------------------------------------------------------------------
+
+    // Ghi nhận bản ghi sinh viên mới/đã sửa vào nhật ký (chỉ khi bật chế độ journal)
+    void recordPut(const Student& student) {
+        if (journaling()) {
+            appendJournal({{"op", "put"}, {"student", student.toJson()}});
+        }
+    }
+
+    void recordRemove(const std::string& id) {
+        if (journaling()) {
+            appendJournal({{"op", "del"}, {"id", id}});
+        }
+    }
+
+    // Đổi tên khoa/tình trạng/chương trình chỉ cần một bản ghi, không phải một bản ghi mỗi sinh viên
+    void recordRename(const std::string& field, const std::string& from, const std::string& to) {
+        if (journaling()) {
+            appendJournal({{"op", "rename"}, {"field", field}, {"from", from}, {"to", to}});
+        }
+    }
+
+    // Có cần tạo bản ghi nhật ký không (batch lớn sẽ được lưu bằng snapshot)
+    bool journaling() const {
+        return journal_.isOpen() && !batchSnapshot_;
+    }
+
+    // Trong batch, bản ghi được giữ lại đến commit(). Khi số bản ghi đạt ngưỡng gộp nhật ký,
+    // batch được lưu bằng một snapshot nên không cần giữ chúng nữa.
+    void appendJournal(json record) {
+        if (!inBatch()) {
+            journal_.append(record);
+            return;
+        }
+        stagedJournal_.push_back(std::move(record));
+        if (stagedJournal_.size() >= static_cast<size_t>(ConfigManager::getInstance().getJournalCompactThreshold())) {
+            stagedJournal_ = json::array();
+            batchSnapshot_ = true;
+        }
+    }
+
+    // Lưu các thay đổi: fsync nhật ký (gộp vào snapshot khi đủ ngưỡng),
+    // hoặc ghi lại toàn bộ students.json nếu không dùng journal.
+    void persistChanges() {
+        if (inBatch()) {
+            studentsDirty_ = true; // Lưu khi commit()
+            return;
+        }
+        if (!journal_.isOpen()) {
+            scheduleStudentSave();
+            return;
+        }
+        journal_.sync();
+        markDataWritten();
+        size_t threshold = static_cast<size_t>(ConfigManager::getInstance().getJournalCompactThreshold());
+        if (journal_.recordCount() >= threshold) {
+            saveStudentDataToFile();
+            Logger::getInstance().log("Compacted student journal into snapshot.");
+        }
+    }
+
+    void persistList(const std::string& filename, const std::vector<std::string>& data) {
+        listRevision_.fetch_add(1); // Mọi thay đổi danh sách đều đi qua đây
+        if (inBatch()) {
+            dirtyLists_.insert(filename);
+            return;
+        }
+        scheduleListSave(filename, data);
+    }
+
+    // Đánh dấu dữ liệu sinh viên cần ghi và giao việc cho luồng nền. Đường ghi không sao chép
+    // students_: khi đến hạn, luồng nền tự chụp lại danh sách bản ghi (bất biến).
+    void scheduleStudentSave() {
+        studentsVersion_.fetch_add(1);
+        persistence_.schedule(kStudentsDataset, [this] { writeStudentsInBackground(); });
+    }
+
+    // Chạy trên luồng của persistence_. Khóa đọc chỉ được giữ khi chép danh sách con trỏ tới
+    // các bản ghi; tuần tự hóa, ghi và fsync file tạm diễn ra ngoài mọi khóa. Tác vụ này vẫn
+    // cần khóa đọc nên luồng đang giữ khóa ghi không được chờ nó (persistence_.flush()/
+    // discard()) mà phải tự gọi saveStudentDataToFile(). Kết quả được áp dụng bởi applyBackgroundSave().
+    void writeStudentsInBackground() {
+        std::vector<StudentPtr> rows;
+        std::shared_ptr<std::pmr::monotonic_buffer_resource> arena; // Giữ vùng nhớ của `rows`
+        std::string filename;
+        bool binary = false;
+        JsonOutputStyle style = JsonOutputStyle::Pretty;
+        uint64_t version = 0;
+        {
+            RepositoryLock::ReadGuard guard(lock_);
+            version = studentsVersion_.load();
+            if (studentsSaved_.load() >= version || journal_.damaged()) {
+                return; // Đã được ghi, hoặc không được ghi (xem saveStudentDataToFile())
+            }
+            rows = students_;
+            arena = arena_;
+            filename = dataFilename();
+            binary = useBinarySnapshot();
+            style = ConfigManager::getInstance().getJsonOutputStyle();
+        }
+        std::string content = binary ? encodeStudentSnapshot(rows) : studentsJson(rows, style);
+        rows.clear();
+        BackgroundSave result;
+        if (!installStudentFile(filename, filename + ".bg.tmp", content, version, false, &result.stamp.snapshot)) {
+            return;
+        }
+        if (!binary) {
+            result.hash = hashFileEnd(hashFileEnd(hashBytes(kFnvOffset, content.data(), content.size())));
+            result.hashValid = true;
+        }
+        result.stamp.journal = statFile(journalFilename_);
+        result.done = true;
+        std::lock_guard<std::mutex> lock(backgroundSaveMutex_);
+        backgroundSave_ = result;
+        Logger::getInstance().log("Saved student data to file.");
+    }
+
+    // Có thay đổi của dữ liệu sinh viên chưa được ghi xuống file
+    bool studentSavePending() const {
+        return studentsSaved_.load() < studentsVersion_.load();
+    }
+
+    static std::string studentsJson(const std::vector<StudentPtr>& rows, JsonOutputStyle style) {
+        json j = json::array();
+        for (const StudentPtr& student : rows) {
+            j.push_back(student->toJson());
+        }
+        return dumpJson(j, style);
+    }
+
+    void scheduleListSave(const std::string& filename, const std::vector<std::string>& data) {
+        std::string content = dumpJson(json(data), ConfigManager::getInstance().getJsonOutputStyle());
+        persistence_.schedule(filename, [filename, content] { writeFileAtomicWithDigest(filename, content); });
+    }
+
+    // Ghi nhận lần ghi nền gần nhất của dữ liệu sinh viên để reloadIfChanged() không coi
+    // chính file vừa ghi là thay đổi từ bên ngoài
+    void applyBackgroundSave() {
+        std::lock_guard<std::mutex> lock(backgroundSaveMutex_);
+        if (backgroundSave_.done) {
+            loadedStamp_ = backgroundSave_.stamp;
+            loadedHash_ = backgroundSave_.hash;
+            loadedHashValid_ = backgroundSave_.hashValid;
+            backgroundSave_ = BackgroundSave();
+        }
+    }
+
+    const std::vector<std::string>& listData(const std::string& filename) const {
+        if (filename == facultyFilename_) return faculties_;
+        if (filename == statusFilename_) return statuses_;
+        return programs_;
+    }
+
+    void resetBatch() {
+        undoLog_.clear();
+        batchLists_ = {};
+        stagedJournal_ = json::array();
+        batchSnapshot_ = false;
+        studentsDirty_ = false;
+        dirtyLists_.clear();
+    }
+
+    // Cách hoàn tác một thay đổi của students_ trong batch
+    struct UndoEntry {
+        enum Kind { Append, Replace, Erase, Rename } kind;
+        size_t slot = 0;             // Replace/Erase: vị trí bị thay/xóa; Append: số sinh viên thêm liên tiếp
+        StudentPtr row;              // Replace/Erase: bản ghi trước thay đổi
+        std::string field, from, to; // Rename: đổi tên trong từ điển
+        uint32_t code = 0;
+    };
+
+    // Ghi nhận cách hoàn tác một thay đổi của students_ (chỉ khi đang trong batch)
+    void recordUndo(UndoEntry entry) {
+        if (batchDepth_ == 0) {
+            return;
+        }
+        if (entry.kind == UndoEntry::Append) {
+            // Gộp các lần thêm liên tiếp (ví dụ khi nhập hàng loạt) thành một bản ghi
+            if (!undoLog_.empty() && undoLog_.back().kind == UndoEntry::Append) {
+                ++undoLog_.back().slot;
+                return;
+            }
+            entry.slot = 1;
+        }
+        undoLog_.push_back(std::move(entry));
+    }
+
+    // Hoàn tác `entry`; students_ phải đúng như ngay sau thay đổi tương ứng
+    void undo(const UndoEntry& entry) {
+        switch (entry.kind) {
+            case UndoEntry::Append:
+                for (size_t i = 0; i < entry.slot; ++i) {
+                    popRow();
+                }
+                break;
+            case UndoEntry::Replace:
+                setRow(entry.slot, entry.row);
+                break;
+            case UndoEntry::Erase:
+                if (entry.slot == students_.size()) {
+                    pushRow(entry.row);
+                } else {
+                    // Sinh viên cuối đã được chuyển vào chỗ trống: đưa về cuối
+                    StudentPtr moved = students_[entry.slot];
+                    setRow(entry.slot, entry.row);
+                    pushRow(std::move(moved));
+                }
+                break;
+            case UndoEntry::Rename: {
+                RenamableField target;
+                renamableField(entry.field, target);
+                if (target.dictionary->rename(entry.code, entry.from)) {
+                    target.index->renameKey(entry.to, entry.from);
+                    break;
+                }
+                // `from` đã có mã mới trong batch: gán giá trị cũ cho những sinh viên còn dùng mã đã đổi tên
+                std::vector<size_t> slots;
+                for (size_t slot : target.index->find(entry.to)) {
+                    if (((*students_[slot]).*target.code)() == entry.code) {
+                        slots.push_back(slot);
+                    }
+                }
+                setFieldValue(target, std::move(slots), entry.from);
+                break;
+            }
+        }
+    }
+
+    // Áp dụng nhật ký lên snapshot vừa nạp. Nếu chế độ journal đã tắt mà vẫn còn
+    // nhật ký cũ, gộp luôn vào students.json để không mất thay đổi.
+    void replayJournal() {
+        size_t applied = journal_.replay([this](const json& record) { applyJournalRecord(record); });
+        if (journal_.damaged()) {
+            // Không biết các thay đổi sau bản ghi hỏng: nạp thất bại như khi students.json hỏng.
+            // Dữ liệu sinh viên không được lưu (xem saveStudentDataToFile) nên file nào cũng
+            // được giữ nguyên cho tới khi nhật ký được sửa và nạp lại.
+            clearStudentData();
+            std::cout << "Lỗi: " << journalFilename_ << " có bản ghi hỏng. Dữ liệu sinh viên chưa được nạp "
+                      << "và sẽ không được lưu cho tới khi sửa file.\n";
+            return;
+        }
+        if (applied > 0) {
+            Logger::getInstance().log("Replayed " + std::to_string(applied) + " journal records.");
+            if (!journal_.isOpen()) {
+                saveStudentDataToFile();
+            }
+        }
+    }
+
+    void applyJournalRecord(const json& record) {
+        const std::string op = record.value("op", "");
+        if (op == "put") {
+            appendStudent(heapRow(Student::fromJson(record["student"])));
+        } else if (op == "rename") {
+            renameFieldValue(record.value("field", ""), record.value("from", ""), record.value("to", ""));
+        } else if (op == "del") {
+            auto entry = idIndex_.find(record.value("id", ""));
+            if (entry != idIndex_.end()) {
+                eraseSlot(entry->second);
+            }
+        } else if (op == "batch") {
+            for (const json& operation : record.value("ops", json::array())) {
+                applyJournalRecord(operation);
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------
+    // Snapshot
+    //-----------------------------------------------------------------------
+
+    bool useBinarySnapshot() const {
+        return ConfigManager::getInstance().getStorageFormat() == "binary";
+    }
+
+    const std::string& dataFilename() const {
+        return useBinarySnapshot() ? binaryFilename_ : studentFilename_;
+    }
+
+    // Kích thước students.json tối thiểu để hiện tiến độ khi nạp
+    static constexpr size_t kLoadProgressMinBytes = 16 << 20;
+
+    // Đọc students.json theo kiểu SAX: mỗi sinh viên được thêm vào ngay khi đọc xong, không
+    // dựng cây JSON của cả file. File lớn thì hiện tiến độ theo phần trăm.
+    void loadJsonSnapshot() {
+        struct stat st;
+        if (::stat(studentFilename_.c_str(), &st) != 0) {
+            std::cout << "Không thể mở file để đọc dữ liệu. Tạo file mới.\n";
+            Logger::getInstance().log("Could not open file to load data. Creating new file.");
+            return;
+        }
+        bool showProgress = static_cast<size_t>(st.st_size) >= kLoadProgressMinBytes;
+        int shownPercent = -1;
+        std::string error;
+        bool verified = false;
+        bool ok = readStudentJson(studentFilename_,
+            [this](Student&& student) { appendStudent(arenaRow(std::move(student))); },
+            [&](size_t bytesRead, size_t totalBytes, size_t count) {
+                int percent = totalBytes ? static_cast<int>(bytesRead * 100 / totalBytes) : 100;
+                if (showProgress && percent != shownPercent) {
+                    shownPercent = percent;
+                    std::cout << "\rĐang nạp " << studentFilename_ << ": " << percent << "% (" << count
+                              << " sinh viên)" << std::flush;
+                }
+            },
+            arena_.get(), &error, &verified);
+        if (showProgress) {
+            std::cout << "\n";
+        }
+        if (ok) {
+            Logger::getInstance().log("Loaded student data from file.");
+            // Không khớp tóm tắt: file không phải bản chương trình đã ghi (sửa từ bên ngoài, hỏng
+            // hoặc ghi bởi phiên bản cũ), nên không được tin mà phải kiểm tra lại
+            revalidatePending_ = !verified;
+        } else {
+            // Không giữ dữ liệu nạp dở: một lần lưu sau đó sẽ ghi đè file gốc
+            clearStudentData();
+            std::cout << "Lỗi: " << studentFilename_ << " không hợp lệ (" << error << ").\n";
+        }
+    }
+
+    void loadBinarySnapshot() {
+        std::vector<Student> loaded;
+        if (readStudentSnapshot(binaryFilename_, loaded, arena_.get())) {
+            students_.reserve(loaded.size());
+            idIndex_.reserve(loaded.size());
+            columns_.reserve(loaded.size());
+            for (Student& student : loaded) {
+                appendStudent(arenaRow(std::move(student))); // Cùng arena: chỉ chuyển con trỏ chuỗi
+            }
+            Logger::getInstance().log("Loaded student data from binary snapshot.");
+        } else {
+            std::cout << "Không thể đọc snapshot nhị phân " << binaryFilename_ << ". Tạo file mới.\n";
+            Logger::getInstance().log("Could not load binary snapshot. Creating new file.");
+        }
+    }
+
+    //-----------------------------------------------------------------------
+    // Change detection
+    //-----------------------------------------------------------------------
+
+    struct FileStamp {
+        long long mtimeNs = -1;
+        long long size = -1;
+        bool operator==(const FileStamp& other) const {
+            return mtimeNs == other.mtimeNs && size == other.size;
+        }
+    };
+
+    struct DataStamp {
+        FileStamp snapshot;
+        FileStamp journal;
+        bool operator==(const DataStamp& other) const {
+            return snapshot == other.snapshot && journal == other.journal;
+        }
+    };
+
+    static FileStamp statFile(const std::string& filename) {
+        FileStamp stamp;
+        struct stat st;
+        if (::stat(filename.c_str(), &st) == 0) {
+            stamp.mtimeNs = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+            stamp.size = static_cast<long long>(st.st_size);
+        }
+        return stamp;
+    }
+
+    DataStamp currentDataStamp() const {
+        return {statFile(dataFilename()), statFile(journalFilename_)};
+    }
+
+    static constexpr uint64_t kFnvOffset = 14695981039346656037ULL;
+
+    // FNV-1a 64-bit
+    static uint64_t hashBytes(uint64_t hash, const char* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // Byte phân tách giữa nội dung các file để hash không bị trùng khi dịch ranh giới
+    static uint64_t hashFileEnd(uint64_t hash) {
+        return hashBytes(hash, "\xff", 1);
+    }
+
+    // Hash nội dung students.json và nhật ký
+    uint64_t hashDataFiles() const {
+        uint64_t hash = kFnvOffset;
+        std::vector<char> buffer(1 << 16);
+        for (const std::string* filename : {&dataFilename(), &journalFilename_}) {
+            std::ifstream file(*filename, std::ios::binary);
+            while (file) {
+                file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                hash = hashBytes(hash, buffer.data(), static_cast<size_t>(file.gcount()));
+            }
+            hash = hashFileEnd(hash);
+        }
+        return hash;
+    }
+
+    // Gọi sau khi chính chương trình ghi dữ liệu để không nạp lại vô ích
+    void markDataWritten() {
+        loadedStamp_ = currentDataStamp();
+        loadedHashValid_ = false;
+    }
+
+    // Ghi `content` (phiên bản `version` của dữ liệu sinh viên) vào file tạm `temp` rồi đổi tên
+    // đè lên `filename`. studentFileMutex_ chỉ được giữ quanh phép rename: lần ghi nền
+    // (`always` = false) bỏ qua nếu file đã chứa phiên bản mới hơn, còn lần ghi đồng bộ
+    // (đang giữ khóa ghi nên luôn là bản mới nhất) luôn ghi. `stamp`: mtime/kích thước ngay
+    // sau rename, trước khi lần ghi khác kịp thay file. students.json được ghi kèm file tóm tắt
+    // như writeFileAtomicWithDigest (students.bin có checksum riêng ở footer).
+    bool installStudentFile(const std::string& filename, const std::string& temp, const std::string& content,
+                            uint64_t version, bool always, FileStamp* stamp) {
+        const bool withDigest = filename == studentFilename_;
+        const std::string sum = digestFilename(filename);
+        const std::string sumTemp = sum + temp.substr(filename.size());
+        if (!writeTempFile(filename, temp, {content})) {
+            return false;
+        }
+        if (withDigest) {
+            FileDigest digest;
+            digest.update(content);
+            if (!writeTempFile(sum, sumTemp, {digest.text()})) {
+                std::remove(temp.c_str());
+                return false;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> fileLock(studentFileMutex_);
+            if (!always && studentsSaved_.load() >= version) {
+                std::remove(temp.c_str());
+                std::remove(sumTemp.c_str());
+                return false;
+            }
+            if (!renameTempFile(filename, temp)) {
+                std::remove(sumTemp.c_str());
+                return false;
+            }
+            if (withDigest && !renameTempFile(sum, sumTemp)) {
+                std::remove(sum.c_str()); // Tóm tắt cũ không còn đúng với nội dung mới
+            }
+            if (studentsSaved_.load() < version) {
+                studentsSaved_.store(version);
+            }
+            *stamp = statFile(filename);
+        }
+        if (!syncParentDirectory(filename)) {
+            Logger::getInstance().log("Failed to fsync directory of " + filename, LogLevel::Error);
+        }
+        return true;
+    }
+
+    // Helper function to save data to file
+
+    void saveDataToFile(const std::string& filename, const std::vector<std::string>& data) {
+        persistence_.discard(filename);
+        json j = data;
+        writeFileAtomicWithDigest(filename, dumpJson(j, ConfigManager::getInstance().getJsonOutputStyle()));
+    }
+
+    // Nhiều luồng đọc, một luồng ghi (xem RepositoryLock); bảo vệ mọi thành viên bên dưới
+    // trừ persistence_, backgroundSave_ và các phiên bản ghi nền (có khóa riêng hoặc atomic)
+    mutable RepositoryLock lock_;
+
+    static std::shared_ptr<std::pmr::monotonic_buffer_resource> newArena() {
+        return std::make_shared<std::pmr::monotonic_buffer_resource>(1 << 20);
+    }
+
+    // Arena chứa các bản ghi nạp từ snapshot cùng chuỗi của chúng; được thay bằng arena mới
+    // khi nạp lại. Lần ghi nền giữ một tham chiếu trong lúc dùng các bản ghi cũ.
+    // Khai báo trước students_ để bị hủy sau cùng.
+    std::shared_ptr<std::pmr::monotonic_buffer_resource> arena_ = newArena();
+    std::vector<StudentPtr> students_; // Bản ghi bất biến: sửa sinh viên là thay con trỏ
+    StudentColumns columns_; // Mã từ điển và thời điểm tạo của students_ (cùng vị trí) cho các lượt quét
+    std::unordered_map<std::string, size_t> idIndex_; // MSSV -> vị trí trong students_
+    StudentIndex facultyIndex_;  // Khoa -> các vị trí trong students_
+    StudentIndex statusIndex_;
+    StudentIndex programIndex_;
+    StudentIndex courseIndex_;
+    NameSearchIndex nameIndex_;  // Trigram trên họ tên đã bỏ dấu
+    mutable FuzzyIndex idFuzzy_;   // BK-tree theo MSSV
+    mutable FuzzyIndex nameFuzzy_; // BK-tree theo họ tên đã bỏ dấu
+    mutable std::atomic<bool> fuzzyBuilt_{false};
+    mutable std::mutex fuzzyMutex_; // Tuần tự hóa buildFuzzyIndexes() giữa các luồng đọc
+    StudentValidator* validator_;
+    bool revalidatePending_ = false; // students.json vừa nạp chưa được kiểm tra lại (xem loadJsonSnapshot)
+    const std::string studentFilename_ = "students.json";
+    const std::string binaryFilename_ = "students.bin";
+    const std::string journalFilename_ = "students.journal";
+    StudentJournal journal_;
+    DataStamp loadedStamp_;
+    uint64_t loadedHash_ = 0;
+    bool loadedHashValid_ = false;
+
+    // Batch đang mở (xem beginBatch)
+    size_t batchDepth_ = 0;
+    std::vector<UndoEntry> undoLog_;                 // Theo thứ tự thay đổi; rollback() đi ngược
+    std::array<std::vector<std::string>, 3> batchLists_; // Khoa, tình trạng, chương trình trước batch
+    json stagedJournal_ = json::array(); // Bản ghi nhật ký chờ commit()
+    bool batchSnapshot_ = false;         // Batch sẽ được lưu bằng snapshot thay vì nhật ký
+    bool studentsDirty_ = false;
+    std::set<std::string> dirtyLists_;   // File danh sách khoa/tình trạng/chương trình cần ghi
+
+    // Kết quả lần ghi nền gần nhất của dữ liệu sinh viên (ghi bởi luồng nền)
+    struct BackgroundSave {
+        bool done = false;
+        DataStamp stamp;
+        uint64_t hash = 0;
+        bool hashValid = false;
+    };
+    std::mutex backgroundSaveMutex_;
+    BackgroundSave backgroundSave_;
+    // Phiên bản dữ liệu sinh viên: tăng ở mỗi thay đổi chờ ghi nền; studentsSaved_ là phiên
+    // bản file đang chứa. studentFileMutex_ tuần tự hóa các lần ghi file dữ liệu sinh viên.
+    std::atomic<unsigned long> listRevision_{0};
+    std::atomic<uint64_t> studentsVersion_{0};
+    std::atomic<uint64_t> studentsSaved_{0};
+    std::mutex studentFileMutex_;
+    static constexpr const char* kStudentsDataset = "students";
+
+    // Filenames for Faculty, Status, and Program
+
+    const std::string facultyFilename_ = "faculties.json";
+    const std::string statusFilename_ = "statuses.json";
+    const std::string programFilename_ = "programs.json";
+
+    // Data Members for Faculty, Status, and Program
+    std::vector<std::string> faculties_ = {"FL", "FBE", "FJPN", "FFR"};  // Initial values
+    std::vector<std::string> statuses_ = {"Active", "Graduated", "Leave", "Absent"}; // Initial values
+    std::vector<std::string> programs_ = {"Advanced Program", "Formal Program", "High Quality Program"}; // Initial values
+
+    // Khai báo sau cùng để bị hủy đầu tiên: destructor ghi nốt các tác vụ (dùng `this`)
+    // khi mọi thành viên khác còn nguyên
+    PersistenceScheduler persistence_{std::chrono::milliseconds(ConfigManager::getInstance().getPersistIntervalMs())};
+};
+
+
+class ConcreteStudentValidator : public StudentValidator {
+public:
+    ConcreteStudentValidator(class StudentRepository* repo) : repo_(repo) {}
+
+    bool isValid(const Student& student) override {
+        refreshConfig();
+        refreshLists();
+        std::string error;
+        if (!check(student.getEmailView(), student.getPhoneView(), student.getFaculty(), student.getStatus(),
+                   student.getGender(), student.getProgram(), student.getCourseView(), student.getDobView(), error)) {
+            std::cout << error << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    bool isValidRecord(const std::vector<std::string>& record, std::string& error) const override {
+        if (record.size() != 11 && record.size() != 12) { // Trường 12 (nếu có): creationTime
+            error = "Dữ liệu không hợp lệ.";
+            return false;
+        }
+        return check(record[8], record[9], record[4], record[10], record[3], record[6], record[5], record[2], error);
+    }
+
+    void prepareRecordValidation() override {
+        refreshConfig();
+        refreshLists();
+    }
+
+private:
+    // Nạp lại đuôi email và mẫu số điện thoại khi ConfigManager thay đổi;
+    // regex chỉ được biên dịch một lần cho mỗi lần đổi cấu hình.
+    void refreshConfig() {
+        const ConfigManager& config = ConfigManager::getInstance();
+        if (configRevision_ == config.getRevision()) {
+            return;
+        }
+        configRevision_ = config.getRevision();
+        emailSuffix_ = config.getEmailSuffix();
+
+        // Nếu chuỗi không bắt đầu bằng '^', cho rằng đây là tiền tố literal: không cần regex
+        std::string phonePattern = config.getPhoneRegex();
+        phoneIsPrefix_ = phonePattern.empty() || phonePattern.front() != '^';
+        phonePrefix_ = phoneIsPrefix_ ? phonePattern : std::string();
+        phonePatternValid_ = true;
+        if (!phoneIsPrefix_) {
+            try {
+                phonePattern_.assign(phonePattern, std::regex::ECMAScript | std::regex::optimize);
+            } catch (std::regex_error& e) {
+                std::cerr << "Regex error: " << e.what() << std::endl;
+                phonePatternValid_ = false;
+            }
+        }
+    }
+
+    // Chụp danh sách khoa/tình trạng/chương trình hợp lệ khi repository báo danh sách đã đổi.
+    // isValidRecord() chạy trên các luồng kiểm tra trong khi luồng nhập đang giữ khóa ghi của
+    // repository, nên không được gọi lại repository mà dùng bản chụp này (danh sách không đổi
+    // trong lúc nhập).
+    void refreshLists() {
+        // Đọc revision trước khi chép: thay đổi xen giữa sẽ làm lần gọi sau chụp lại
+        unsigned long revision = repo_->getListRevision();
+        if (listRevision_ == revision) {
+            return;
+        }
+        listRevision_ = revision;
+        std::vector<std::string> faculties = repo_->getFaculties();
+        std::vector<std::string> statuses = repo_->getStatuses();
+        std::vector<std::string> programs = repo_->getPrograms();
+        faculties_.clear();
+        faculties_.insert(faculties.begin(), faculties.end());
+        statuses_.clear();
+        statuses_.insert(statuses.begin(), statuses.end());
+        programs_.clear();
+        programs_.insert(programs.begin(), programs.end());
+    }
+
+    // Các quy tắc theo thứ tự kiểm tra; dùng cấu hình và danh sách đã nạp bởi
+    // refreshConfig()/refreshLists()
+    bool check(std::string_view email, std::string_view phone, const std::string& faculty, const std::string& status,
+               const std::string& gender, const std::string& program, std::string_view course, std::string_view dob,
+               std::string& error) const {
+        if (ConfigManager::getInstance().getEnforceValidation()) {
+            if (!isValidEmail(email)) {
+                error = "Email không hợp lệ.";
+                return false;
+            }
+            if (!isValidPhone(phone)) {
+                error = "Số điện thoại không hợp lệ.";
+                return false;
+            }
+        }
+        if (faculties_.count(faculty) == 0) {
+            error = "Khoa không hợp lệ.";
             return false;
         }
+        if (statuses_.count(status) == 0) {
+            error = "Tình trạng sinh viên không hợp lệ.";
+            return false;
+        }
+        if (!isValidGender(gender)) {
+            error = "Giới tính không hợp lệ. (Male, Female)";
+            return false;
+        }
+        if (programs_.count(program) == 0) {
+            error = "Chương trình không hợp lệ. (Advanced Program, Formal Program, High Quality Program)";
+            return false;
+        }
+        if (!isValidCourse(course)) {
+            error = "Khóa không hợp lệ. (YYYY)";
+            return false;
+        }
+        if (!isValidDOB(dob)) {
+            error = "Ngày sinh không hợp lệ. (DD/MM/YYYY)";
+            return false;
+        }
+        return true;
+    }
+
+    // Kiểm tra email: phải kết thúc với đuôi đã cấu hình
+    bool isValidEmail(std::string_view email) const {
+        if (email.size() < emailSuffix_.size()) return false;
+        return email.compare(email.size() - emailSuffix_.size(), emailSuffix_.size(), emailSuffix_) == 0;
+    }
+
+    bool isValidPhone(std::string_view phone) const {
+        if (phoneIsPrefix_) {
+            return phone.compare(0, phonePrefix_.size(), phonePrefix_) == 0;
+        }
+        return phonePatternValid_ && std::regex_match(phone.begin(), phone.end(), phonePattern_);
     }
 
     // Các hàm xác thực cũ (gender, course, DOB) giữ nguyên...
-    bool isValidGender(const std::string& gender) {
+    bool isValidGender(const std::string& gender) const {
         return (gender == "Male" || gender == "Female");
     }
 
-    bool isValidCourse(const std::string& course) {
-        const std::regex pattern(R"(\d{4})");
-        return std::regex_match(course, pattern);
+    static bool isDigits(std::string_view s, size_t pos, size_t count) {
+        for (size_t i = pos; i < pos + count; ++i) {
+            if (s[i] < '0' || s[i] > '9') return false;
+        }
+        return true;
+    }
+
+    // YYYY
+    bool isValidCourse(std::string_view course) const {
+        return course.size() == 4 && isDigits(course, 0, 4);
     }
 
-    bool isValidDOB(const std::string& dob) {
-        const std::regex pattern(R"(\d{2}/\d{2}/\d{4})");
-        return std::regex_match(dob, pattern);
+    // DD/MM/YYYY
+    bool isValidDOB(std::string_view dob) const {
+        return dob.size() == 10 && isDigits(dob, 0, 2) && dob[2] == '/' &&
+               isDigits(dob, 3, 2) && dob[5] == '/' && isDigits(dob, 6, 4);
     }
 
+    unsigned long configRevision_ = static_cast<unsigned long>(-1);
+    unsigned long listRevision_ = static_cast<unsigned long>(-1);
+    std::string emailSuffix_;
+    bool phoneIsPrefix_ = true;
+    std::string phonePrefix_;
+    std::regex phonePattern_;
+    bool phonePatternValid_ = true;
+    std::unordered_set<std::string> faculties_;
+    std::unordered_set<std::string> statuses_;
+    std::unordered_set<std::string> programs_;
     StudentRepository* repo_;
 };
 
@@ -0,0 +1,286 @@
+#include "StudentApi.hpp"
+#include "Student.hpp"
+#include "StatusRulesManager.hpp"
+#include "CertificateGenerator.hpp"
+#include <ctime>
+
+namespace {
+
+const char* const kStudentKeys[] = {"id", "name", "dob", "gender", "faculty", "course",
+                                    "program", "address", "email", "phone", "status"};
+
+HttpResponse jsonResponse(int status, const json& body) {
+    HttpResponse response;
+    response.status = status;
+    response.body = body.dump();
+    return response;
+}
+
+HttpResponse errorResponse(int status, const std::string& message) {
+    return jsonResponse(status, {{"error", message}});
+}
+
+json studentsBody(const std::vector<Student>& students) {
+    json list = json::array();
+    for (const Student& student : students) {
+        list.push_back(student.toJson());
+    }
+    return {{"count", students.size()}, {"students", std::move(list)}};
+}
+
+HttpResponse studentsResponse(const std::vector<Student>& students) {
+    return jsonResponse(200, studentsBody(students));
+}
+
+// Tham số query dạng số không âm; `fallback` nếu không có
+bool sizeParam(const HttpRequest& request, const std::string& name, size_t fallback, size_t& value) {
+    auto entry = request.query.find(name);
+    if (entry == request.query.end()) {
+        value = fallback;
+        return true;
+    }
+    const std::string& text = entry->second;
+    if (text.empty() || text.size() > 9 || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    value = std::stoul(text);
+    return true;
+}
+
+std::string queryParam(const HttpRequest& request, const std::string& name) {
+    auto entry = request.query.find(name);
+    return entry == request.query.end() ? std::string() : entry->second;
+}
+
+// Body JSON là một đối tượng có các trường sinh viên là chuỗi; false và `error` nếu không
+bool parseStudentBody(const std::string& body, json& object, std::string& error) {
+    object = json::parse(body, nullptr, false);
+    if (!object.is_object()) {
+        error = "Body phải là một đối tượng JSON.";
+        return false;
+    }
+    for (const char* key : kStudentKeys) {
+        auto field = object.find(key);
+        if (field != object.end() && !field->is_string()) {
+            error = std::string("Trường '") + key + "' phải là chuỗi.";
+            return false;
+        }
+    }
+    return true;
+}
+
+HttpResponse listStudents(StudentRepository& repo, const HttpRequest& request) {
+    size_t limit, offset;
+    if (!sizeParam(request, "limit", 100, limit) || !sizeParam(request, "offset", 0, offset)) {
+        return errorResponse(400, "limit/offset phải là số không âm.");
+    }
+    std::string name = queryParam(request, "name");
+    std::string faculty = queryParam(request, "faculty");
+    std::string mode = queryParam(request, "mode");
+    if (!mode.empty() && mode != "prefix" && mode != "substring") {
+        return errorResponse(400, "mode phải là prefix hoặc substring.");
+    }
+    if (name.empty() && faculty.empty()) {
+        StudentQuery all;
+        all.limit = limit;
+        all.offset = offset;
+        return studentsResponse(repo.query(all));
+    }
+    std::vector<Student> found;
+    if (faculty.empty()) {
+        NameMatchMode match = mode == "prefix" ? NameMatchMode::Prefix : NameMatchMode::Substring;
+        found = repo.searchByName(name, match, limit + offset);
+    } else {
+        found = repo.searchStudents(faculty, name);
+    }
+    if (offset >= found.size()) {
+        found.clear();
+    } else {
+        found.erase(found.begin(), found.begin() + static_cast<std::ptrdiff_t>(offset));
+        if (found.size() > limit) {
+            found.erase(found.begin() + static_cast<std::ptrdiff_t>(limit), found.end());
+        }
+    }
+    return studentsResponse(found);
+}
+
+HttpResponse addStudent(StudentRepository& repo, const HttpRequest& request) {
+    json object;
+    std::string error;
+    if (!parseStudentBody(request.body, object, error)) {
+        return errorResponse(400, error);
+    }
+    std::vector<std::string> fields;
+    for (const char* key : kStudentKeys) {
+        if (!object.contains(key)) {
+            return errorResponse(400, std::string("Thiếu trường '") + key + "'.");
+        }
+        fields.push_back(object[key].get<std::string>());
+    }
+    Student student(fields[0], fields[1], fields[2], fields[3], fields[4], fields[5], fields[6], fields[7],
+                    fields[8], fields[9], fields[10]);
+    switch (repo.tryAddStudent(student)) {
+    case StudentWriteResult::Ok:
+        break;
+    case StudentWriteResult::DuplicateId:
+        return errorResponse(409, "MSSV " + fields[0] + " đã tồn tại.");
+    default:
+        return errorResponse(422, "Thông tin sinh viên không hợp lệ.");
+    }
+    // Bản đã lưu có thời gian tạo; yêu cầu khác có thể vừa xóa nó thì trả lại bản đã gửi
+    std::optional<Student> added = repo.getStudent(fields[0]);
+    return jsonResponse(201, (added ? *added : student).toJson());
+}
+
+HttpResponse updateStudent(StudentRepository& repo, const std::string& id, const HttpRequest& request) {
+    json object;
+    std::string error;
+    if (!parseStudentBody(request.body, object, error)) {
+        return errorResponse(400, error);
+    }
+    std::string rejection;
+    std::optional<Student> result;
+    auto text = [&](const char* key) { return object[key].get<std::string>(); };
+    // Chạy dưới khóa ghi của repository: tình trạng hiện tại không đổi đến lúc ghi
+    StudentWriteResult written = repo.tryUpdateStudent(id, [&](Student& edited) {
+        if (object.contains("id")) edited.setId(text("id"));
+        if (object.contains("name")) edited.setName(text("name"));
+        if (object.contains("dob")) edited.setDob(text("dob"));
+        if (object.contains("gender")) edited.setGender(text("gender"));
+        if (object.contains("faculty")) edited.setFaculty(text("faculty"));
+        if (object.contains("course")) edited.setCourse(text("course"));
+        if (object.contains("program")) edited.setProgram(text("program"));
+        if (object.contains("address")) edited.setAddress(text("address"));
+        if (object.contains("email")) edited.setEmail(text("email"));
+        if (object.contains("phone")) edited.setPhone(text("phone"));
+        if (object.contains("status")) {
+            // Quy luật chuyển đổi tình trạng như khi cập nhật qua menu
+            std::string status = edited.getStatus();
+            if (!StatusRulesManager::getInstance().isValidTransition(status, text("status"))) {
+                rejection = "Chuyển đổi từ trạng thái \"" + status + "\" sang \"" + text("status") +
+                            "\" không hợp lệ.";
+                return false;
+            }
+            edited.setStatus(text("status"));
+        }
+        result = edited;
+        return true;
+    });
+    switch (written) {
+    case StudentWriteResult::Ok:
+        return jsonResponse(200, result->toJson());
+    case StudentWriteResult::NotFound:
+        return errorResponse(404, "Không tìm thấy sinh viên với MSSV này.");
+    case StudentWriteResult::DuplicateId:
+        return errorResponse(409, "MSSV " + text("id") + " đã tồn tại.");
+    case StudentWriteResult::Rejected:
+        return errorResponse(422, rejection);
+    default:
+        return errorResponse(422, "Thông tin sinh viên không hợp lệ.");
+    }
+}
+
+HttpResponse removeStudent(StudentRepository& repo, const std::string& id) {
+    switch (repo.tryRemoveStudent(id)) {
+    case StudentWriteResult::Ok:
+        break;
+    case StudentWriteResult::NotFound:
+        return errorResponse(404, "Không tìm thấy sinh viên với MSSV này.");
+    default:
+        return errorResponse(409, "Không được phép xóa sinh viên sau " +
+                                  std::to_string(ConfigManager::getInstance().getDeleteTimeLimit()) +
+                                  " phút kể từ thời điểm tạo.");
+    }
+    HttpResponse response;
+    response.status = 204;
+    return response;
+}
+
+HttpResponse runQuery(StudentRepository& repo, const HttpRequest& request) {
+    StudentQuery query;
+    std::string error;
+    if (!parseStudentQuery(queryParam(request, "q"), query, error)) {
+        return errorResponse(400, error);
+    }
+    QueryStats stats;
+    json body = studentsBody(repo.query(query, &stats));
+    body["index"] = stats.index;
+    body["candidates"] = stats.candidates;
+    return jsonResponse(200, body);
+}
+
+HttpResponse certificate(StudentRepository& repo, const std::string& id, const HttpRequest& request) {
+    std::string format = queryParam(request, "format");
+    if (!format.empty() && format != "md" && format != "docx") {
+        return errorResponse(400, "format phải là md hoặc docx.");
+    }
+    std::optional<Student> student = repo.getStudent(id);
+    if (!student) {
+        return errorResponse(404, "Không tìm thấy sinh viên với MSSV này.");
+    }
+    CertificateData cert = defaultCertificateData();
+    cert.studentID      = student->getId();
+    cert.studentName    = student->getName();
+    cert.studentDOB     = student->getDob();
+    cert.studentGender  = student->getGender();
+    cert.studentFaculty = student->getFaculty();
+    cert.studentProgram = student->getProgram();
+    cert.studentCourse  = student->getCourse();
+    cert.studentStatus  = translateStatus(student->getStatus());
+    cert.confirmationPurpose = queryParam(request, "purpose");
+    if (cert.confirmationPurpose.empty()) {
+        cert.confirmationPurpose = "Xác nhận đang học để vay vốn ngân hàng";
+    }
+    cert.effectiveDate = queryParam(request, "effectiveDate");
+    cert.issueDate = queryParam(request, "issueDate");
+    if (cert.issueDate.empty()) {
+        std::time_t now = std::time(nullptr);
+        std::tm tm{};
+        localtime_r(&now, &tm);
+        char date[16];
+        std::strftime(date, sizeof(date), "%d/%m/%Y", &tm);
+        cert.issueDate = date;
+    }
+    HttpResponse response;
+    bool docx = format == "docx";
+    response.contentType = docx ? "text/plain; charset=utf-8" : "text/markdown; charset=utf-8";
+    response.body = renderCertificate(cert, docx ? CertificateFormat::DOCX : CertificateFormat::MD);
+    return response;
+}
+
+} // namespace
+
+HttpResponse handleStudentApiRequest(StudentRepository& repo, const HttpRequest& request) {
+    const std::string& path = request.path;
+    const std::string& method = request.method;
+    if (path == "/students") {
+        if (method == "GET") return listStudents(repo, request);
+        if (method == "POST") return addStudent(repo, request);
+        return errorResponse(405, "Phương thức không được hỗ trợ.");
+    }
+    if (path == "/query") {
+        if (method == "GET") return runQuery(repo, request);
+        return errorResponse(405, "Phương thức không được hỗ trợ.");
+    }
+    const std::string prefix = "/students/";
+    if (path.compare(0, prefix.size(), prefix) == 0 && path.size() > prefix.size()) {
+        std::string id = path.substr(prefix.size());
+        const std::string suffix = "/certificate";
+        if (id.size() > suffix.size() && id.compare(id.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            id.resize(id.size() - suffix.size());
+            if (method == "GET") return certificate(repo, id, request);
+            return errorResponse(405, "Phương thức không được hỗ trợ.");
+        }
+        if (method == "GET") {
+            std::optional<Student> student = repo.getStudent(id);
+            if (!student) {
+                return errorResponse(404, "Không tìm thấy sinh viên với MSSV này.");
+            }
+            return jsonResponse(200, student->toJson());
+        }
+        if (method == "PUT") return updateStudent(repo, id, request);
+        if (method == "DELETE") return removeStudent(repo, id);
+        return errorResponse(405, "Phương thức không được hỗ trợ.");
+    }
+    return errorResponse(404, "Không có endpoint " + method + " " + path + ".");
+}
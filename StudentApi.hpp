@@ -0,0 +1,22 @@
+#ifndef STUDENT_API_HPP_
+#define STUDENT_API_HPP_
+
+#include "HttpServer.hpp"
+
+class StudentRepository;
+
+// Các endpoint JSON của chế độ máy chủ (--serve). Sinh viên có dạng như trong students.json.
+//   GET    /students?name=&faculty=&mode=prefix|substring&limit=&offset=
+//                                          tìm theo họ tên và/hoặc khoa; không lọc: liệt kê
+//   GET    /students/{id}                  tra theo MSSV
+//   POST   /students                       thêm (đủ 11 trường)
+//   PUT    /students/{id}                  sửa các trường có trong body (như menu cập nhật)
+//   DELETE /students/{id}                  xóa
+//   GET    /query?q=status=Active AND course>=2020 LIMIT 20
+//                                          truy vấn nâng cao (cú pháp của parseStudentQuery)
+//   GET    /students/{id}/certificate?purpose=&effectiveDate=&issueDate=&format=md|docx
+//                                          nội dung giấy xác nhận
+// Lỗi trả về {"error": "..."} với mã HTTP tương ứng. Gọi được đồng thời từ nhiều luồng.
+HttpResponse handleStudentApiRequest(StudentRepository& repo, const HttpRequest& request);
+
+#endif // STUDENT_API_HPP_
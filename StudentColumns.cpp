@@ -0,0 +1,53 @@
+#include "StudentColumns.hpp"
+#include "Student.hpp"
+
+namespace {
+
+int64_t toSeconds(const std::chrono::system_clock::time_point& tp) {
+    return static_cast<int64_t>(std::chrono::system_clock::to_time_t(tp));
+}
+
+template <typename T>
+void swapRemoveValue(std::vector<T>& column, size_t row) {
+    column[row] = column.back();
+    column.pop_back();
+}
+
+} // namespace
+
+void StudentColumns::append(const Student& student) {
+    gender.push_back(student.getGenderCode());
+    faculty.push_back(student.getFacultyCode());
+    program.push_back(student.getProgramCode());
+    status.push_back(student.getStatusCode());
+    creationSeconds.push_back(toSeconds(student.getCreationTime()));
+}
+
+void StudentColumns::assign(size_t row, const Student& student) {
+    gender[row] = student.getGenderCode();
+    faculty[row] = student.getFacultyCode();
+    program[row] = student.getProgramCode();
+    status[row] = student.getStatusCode();
+    creationSeconds[row] = toSeconds(student.getCreationTime());
+}
+
+void StudentColumns::swapRemove(size_t row) {
+    for (std::vector<uint32_t>* column : {&gender, &faculty, &program, &status}) {
+        swapRemoveValue(*column, row);
+    }
+    swapRemoveValue(creationSeconds, row);
+}
+
+void StudentColumns::clear() {
+    for (std::vector<uint32_t>* column : {&gender, &faculty, &program, &status}) {
+        column->clear();
+    }
+    creationSeconds.clear();
+}
+
+void StudentColumns::reserve(size_t rows) {
+    for (std::vector<uint32_t>* column : {&gender, &faculty, &program, &status}) {
+        column->reserve(rows);
+    }
+    creationSeconds.reserve(rows);
+}
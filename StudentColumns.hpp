@@ -0,0 +1,32 @@
+#ifndef STUDENT_COLUMNS_HPP_
+#define STUDENT_COLUMNS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Student;
+
+// Kho lưu trữ dạng cột (structure-of-arrays) cho các trường được quét nhiều: mã khoa,
+// chương trình, tình trạng, giới tính và thời điểm tạo. Mỗi trường là một mảng liền nhau,
+// nên quét một trường (đếm theo tình trạng, lọc truy vấn) chỉ đọc đúng dữ liệu của trường
+// đó. Các trường chuỗi tự do (họ tên, địa chỉ, ...) chỉ nằm trong Student, không sao chép.
+// Dòng i ứng với vị trí i trong repository.
+class StudentColumns {
+public:
+    void append(const Student& student);
+    void assign(size_t row, const Student& student);
+    // Xóa dòng `row` trong O(1): dòng cuối được chuyển vào chỗ trống
+    void swapRemove(size_t row);
+    void clear();
+    void reserve(size_t rows);
+
+    size_t size() const { return status.size(); }
+
+    // Cột mã từ điển (StudentDictionaries)
+    std::vector<uint32_t> gender, faculty, program, status;
+    // Thời điểm tạo, giây Unix
+    std::vector<int64_t> creationSeconds;
+};
+
+#endif // STUDENT_COLUMNS_HPP_
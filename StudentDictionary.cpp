@@ -0,0 +1,85 @@
+#include "StudentDictionary.hpp"
+#include <mutex>
+
+namespace {
+
+// Bộ đệm tra cứu dùng lại (riêng cho mỗi luồng), tránh cấp phát mỗi lần tra
+std::string& probe(std::string_view value) {
+    thread_local std::string buffer;
+    buffer.assign(value.data(), value.size());
+    return buffer;
+}
+
+} // namespace
+
+FieldDictionary::~FieldDictionary() {
+    for (std::atomic<Slot*>& block : blocks_) {
+        delete[] block.load();
+    }
+}
+
+size_t FieldDictionary::blockOf(uint32_t code, size_t& offset) {
+    // Mã đầu tiên của khối b là kFirstBlock * (2^b - 1)
+    uint64_t n = static_cast<uint64_t>(code) / kFirstBlock + 1;
+    size_t block = 0;
+    while ((n >> (block + 1)) != 0) {
+        ++block;
+    }
+    offset = static_cast<size_t>(code - static_cast<uint64_t>(kFirstBlock) * ((uint64_t(1) << block) - 1));
+    return block;
+}
+
+FieldDictionary::Slot& FieldDictionary::slot(uint32_t code) const {
+    size_t offset;
+    size_t block = blockOf(code, offset);
+    return blocks_[block].load(std::memory_order_acquire)[offset];
+}
+
+uint32_t FieldDictionary::intern(std::string_view value) {
+    uint32_t code;
+    if (lookup(value, code)) {
+        return code;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const std::string& key = probe(value);
+    auto entry = codes_.find(key);
+    if (entry != codes_.end()) {
+        return entry->second; // Luồng khác vừa thêm
+    }
+    code = static_cast<uint32_t>(size_.load(std::memory_order_relaxed));
+    size_t offset;
+    size_t block = blockOf(code, offset);
+    if (offset == 0) {
+        // Mã đầu tiên của một khối mới: cấp khối trước khi công bố mã
+        blocks_[block].store(new Slot[static_cast<size_t>(kFirstBlock) << block], std::memory_order_release);
+    }
+    strings_.push_back(key);
+    slot(code).store(&strings_.back(), std::memory_order_release);
+    codes_.emplace(key, code);
+    size_.store(code + 1, std::memory_order_release);
+    return code;
+}
+
+bool FieldDictionary::lookup(std::string_view value, uint32_t& code) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto entry = codes_.find(probe(value));
+    if (entry == codes_.end()) {
+        return false;
+    }
+    code = entry->second;
+    return true;
+}
+
+bool FieldDictionary::rename(uint32_t code, const std::string& newValue) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const std::string& current = value(code);
+    if (codes_.count(newValue) > 0) {
+        return current == newValue;
+    }
+    codes_.erase(current);
+    // Chuỗi cũ vẫn nằm trong strings_: luồng đang đọc tham chiếu tới nó không bị ảnh hưởng
+    strings_.push_back(newValue);
+    slot(code).store(&strings_.back(), std::memory_order_release);
+    codes_.emplace(newValue, code);
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef STUDENT_DICTIONARY_HPP_
+#define STUDENT_DICTIONARY_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Từ điển chuỗi -> mã số nhỏ cho các trường có ít giá trị khác nhau.
+// Mỗi giá trị chỉ được lưu một lần; tham chiếu trả về từ value() luôn hợp lệ
+// (deque không dời phần tử khi thêm mới, và chuỗi cũ được giữ lại khi đổi tên).
+//
+// An toàn khi dùng từ nhiều luồng: intern()/lookup()/rename() dùng khóa đọc-ghi, còn
+// value() không khóa gì (mỗi sinh viên đọc mã của mình rất thường xuyên): mã trỏ tới chuỗi
+// qua một con trỏ atomic trong các khối có địa chỉ cố định.
+class FieldDictionary {
+public:
+    FieldDictionary() = default;
+    ~FieldDictionary();
+    FieldDictionary(const FieldDictionary&) = delete;
+    FieldDictionary& operator=(const FieldDictionary&) = delete;
+
+    // Trả về mã của `value`, thêm mới nếu chưa có
+    uint32_t intern(std::string_view value);
+
+    // Tìm mã của `value` mà không thêm mới
+    bool lookup(std::string_view value, uint32_t& code) const;
+
+    const std::string& value(uint32_t code) const { return *slot(code).load(std::memory_order_acquire); }
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+
+    // Đổi chuỗi của mã `code` thành `newValue`: mọi sinh viên dùng mã này thấy
+    // giá trị mới ngay lập tức. Trả về false nếu `newValue` đã có mã khác.
+    bool rename(uint32_t code, const std::string& newValue);
+
+private:
+    using Slot = std::atomic<const std::string*>;
+
+    // Khối thứ b chứa kFirstBlock * 2^b mã liên tiếp; 26 khối đủ cho mọi mã uint32_t
+    static constexpr uint32_t kFirstBlock = 64;
+    static constexpr size_t kBlockCount = 26;
+
+    // Khối chứa `code` và vị trí của nó trong khối
+    static size_t blockOf(uint32_t code, size_t& offset);
+    Slot& slot(uint32_t code) const;
+
+    mutable std::shared_mutex mutex_;     // Bảo vệ codes_, strings_ và việc cấp khối mới
+    std::deque<std::string> strings_;     // Mọi chuỗi từng dùng (kể cả tên cũ), không bao giờ dời
+    std::unordered_map<std::string, uint32_t> codes_;
+    std::atomic<Slot*> blocks_[kBlockCount] = {};
+    std::atomic<size_t> size_{0};
+};
+
+// Các từ điển dùng chung cho khoa, chương trình, tình trạng và giới tính của sinh viên
+class StudentDictionaries {
+public:
+    static StudentDictionaries& getInstance() {
+        static StudentDictionaries instance;
+        return instance;
+    }
+
+    FieldDictionary faculty;
+    FieldDictionary program;
+    FieldDictionary status;
+    FieldDictionary gender;
+
+private:
+    StudentDictionaries() = default;
+    StudentDictionaries(const StudentDictionaries&) = delete;
+    StudentDictionaries& operator=(const StudentDictionaries&) = delete;
+};
+
+#endif // STUDENT_DICTIONARY_HPP_
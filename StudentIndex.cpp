@@ -0,0 +1,88 @@
+#include "StudentIndex.hpp"
+
+namespace {
+
+// Bộ đệm tra cứu dùng lại (riêng cho mỗi luồng để find() đọc song song được),
+// tránh cấp phát mỗi lần tra
+const std::string& probe(std::string_view key) {
+    thread_local std::string buffer;
+    buffer.assign(key.data(), key.size());
+    return buffer;
+}
+
+} // namespace
+
+void StudentIndex::insert(std::string_view key, size_t slot) {
+    std::vector<size_t>& posting = postings_[probe(key)];
+    if (slot >= positions_.size()) {
+        positions_.resize(slot + 1);
+    }
+    positions_[slot] = posting.size();
+    posting.push_back(slot);
+}
+
+void StudentIndex::erase(std::string_view key, size_t slot) {
+    auto entry = postings_.find(probe(key));
+    if (entry == postings_.end()) {
+        return;
+    }
+    std::vector<size_t>& posting = entry->second;
+    size_t pos = positions_[slot];
+    size_t moved = posting.back();
+    posting[pos] = moved;
+    positions_[moved] = pos;
+    posting.pop_back();
+    if (posting.empty()) {
+        postings_.erase(entry);
+    }
+}
+
+void StudentIndex::relocate(std::string_view key, size_t from, size_t to) {
+    auto entry = postings_.find(probe(key));
+    if (entry == postings_.end()) {
+        return;
+    }
+    if (to >= positions_.size()) {
+        positions_.resize(to + 1);
+    }
+    size_t pos = positions_[from];
+    entry->second[pos] = to;
+    positions_[to] = pos;
+}
+
+void StudentIndex::renameKey(const std::string& oldKey, const std::string& newKey) {
+    auto entry = postings_.find(oldKey);
+    if (entry == postings_.end() || oldKey == newKey) {
+        return;
+    }
+    std::vector<size_t> moving = std::move(entry->second);
+    postings_.erase(entry);
+    std::vector<size_t>& target = postings_[newKey];
+    if (target.empty()) {
+        target = std::move(moving);
+        return;
+    }
+    for (size_t slot : moving) {
+        positions_[slot] = target.size();
+        target.push_back(slot);
+    }
+}
+
+const std::vector<size_t>& StudentIndex::find(std::string_view key) const {
+    static const std::vector<size_t> empty;
+    auto entry = postings_.find(probe(key));
+    return entry != postings_.end() ? entry->second : empty;
+}
+
+std::map<std::string, size_t> StudentIndex::keyCounts() const {
+    std::map<std::string, size_t> counts;
+    for (const auto& entry : postings_) {
+        counts[entry.first] = entry.second.size();
+    }
+    return counts;
+}
+
+void StudentIndex::clear() {
+    postings_.clear();
+    positions_.clear();
+}
@@ -0,0 +1,39 @@
+#ifndef STUDENT_INDEX_HPP_
+#define STUDENT_INDEX_HPP_
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <map>
+
+// Chỉ mục phụ (inverted index): giá trị của một trường -> danh sách vị trí sinh viên.
+// Mỗi vị trí chỉ thuộc đúng một giá trị, nên ta lưu thêm chỗ của nó trong danh sách
+// để thêm/xóa/dời vị trí đều là O(1).
+class StudentIndex {
+public:
+    void insert(std::string_view key, size_t slot);
+    void erase(std::string_view key, size_t slot);
+
+    // Sinh viên ở vị trí `from` được chuyển sang vị trí `to` (xóa kiểu swap-and-pop)
+    void relocate(std::string_view key, size_t from, size_t to);
+
+    // Gộp mọi vị trí của `oldKey` sang `newKey`
+    void renameKey(const std::string& oldKey, const std::string& newKey);
+
+    // Danh sách vị trí có giá trị `key` (rỗng nếu không có), thứ tự không xác định
+    const std::vector<size_t>& find(std::string_view key) const;
+    size_t count(std::string_view key) const { return find(key).size(); }
+
+    size_t keyCount() const { return postings_.size(); }
+    // Số vị trí theo từng giá trị, sắp xếp theo giá trị
+    std::map<std::string, size_t> keyCounts() const;
+    void clear();
+    void reserve(size_t slots) { positions_.reserve(slots); }
+
+private:
+    std::unordered_map<std::string, std::vector<size_t>> postings_;
+    std::vector<size_t> positions_; // vị trí sinh viên -> chỗ của nó trong danh sách
+};
+
+#endif // STUDENT_INDEX_HPP_
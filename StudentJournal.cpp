@@ -0,0 +1,140 @@
+#include "StudentJournal.hpp"
+#include "Logger.hpp"
+#include <fstream>
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+StudentJournal::StudentJournal(const std::string& filename) : filename_(filename) {}
+
+StudentJournal::~StudentJournal() {
+    close();
+}
+
+bool StudentJournal::open(size_t groupCommitSize) {
+    close();
+    groupCommitSize_ = groupCommitSize > 0 ? groupCommitSize : 1;
+    fd_ = ::open(filename_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd_ < 0) {
+        std::cerr << "Error: Could not open journal file: " << filename_ << " (" << std::strerror(errno) << ")\n";
+        Logger::getInstance().log("Could not open journal file: " + filename_, LogLevel::Error);
+        return false;
+    }
+    return true;
+}
+
+void StudentJournal::close() {
+    if (fd_ >= 0) {
+        sync();
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool StudentJournal::append(const json& record) {
+    if (fd_ < 0 || damaged_) return false;
+    buffer_ += record.dump();
+    buffer_ += '\n';
+    ++pending_;
+    ++records_;
+    if (pending_ >= groupCommitSize_) {
+        return sync();
+    }
+    return true;
+}
+
+bool StudentJournal::sync() {
+    if (fd_ < 0 || pending_ == 0) return true;
+    const char* data = buffer_.data();
+    size_t left = buffer_.size();
+    while (left > 0) {
+        ssize_t written = ::write(fd_, data, left);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error: Could not write journal file: " << filename_ << " (" << std::strerror(errno) << ")\n";
+            Logger::getInstance().log("Failed to write journal file: " + filename_, LogLevel::Error);
+            // Phần đã ghi nằm trong file: lần sync sau chỉ ghi tiếp phần còn lại, không ghi lặp
+            buffer_.erase(0, buffer_.size() - left);
+            return false;
+        }
+        data += written;
+        left -= static_cast<size_t>(written);
+    }
+    buffer_.clear();
+    pending_ = 0;
+    if (::fsync(fd_) != 0) {
+        Logger::getInstance().log("Failed to fsync journal file: " + filename_, LogLevel::Error);
+        return false;
+    }
+    return true;
+}
+
+size_t StudentJournal::replay(const std::function<void(const json&)>& apply) {
+    std::ifstream file(filename_);
+    size_t applied = 0;
+    damaged_ = false;
+    if (!file.is_open()) {
+        records_ = 0;
+        return 0;
+    }
+    std::string line;
+    off_t validBytes = 0;
+    bool tornTail = false;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        // Dòng cuối thiếu ký tự xuống dòng là bản ghi ghi dở khi crash
+        if (file.eof()) {
+            tornTail = !line.empty();
+            break;
+        }
+        if (!line.empty()) {
+            json record = json::parse(line, nullptr, false);
+            if (record.is_discarded()) {
+                // Bản ghi đã ghi xong mà vẫn hỏng: không phải do crash khi đang ghi. Cắt đi sẽ
+                // làm mất cả các bản ghi hợp lệ phía sau, nên giữ nguyên file.
+                damaged_ = true;
+                break;
+            }
+            apply(record);
+            ++applied;
+        }
+        validBytes += static_cast<off_t>(line.size() + 1);
+    }
+    file.close();
+    if (damaged_) {
+        Logger::getInstance().log("Corrupt record at line " + std::to_string(lineNumber) + " of " + filename_ +
+                                  "; journal kept unchanged", LogLevel::Error);
+    } else if (tornTail) {
+        // Bản ghi ghi dở do crash: cắt bỏ để các bản ghi mới nối tiếp sau phần hợp lệ
+        Logger::getInstance().log("Journal replay stopped at a torn record at the end of " + filename_);
+        if (::truncate(filename_.c_str(), validBytes) != 0) {
+            Logger::getInstance().log("Failed to truncate corrupt journal tail: " + filename_, LogLevel::Error);
+        }
+    }
+    records_ = applied + pending_;
+    return applied;
+}
+
+bool StudentJournal::reset() {
+    if (damaged_) {
+        Logger::getInstance().log("Not resetting damaged journal: " + filename_, LogLevel::Error);
+        return false;
+    }
+    buffer_.clear();
+    pending_ = 0;
+    records_ = 0;
+    if (fd_ >= 0) {
+        if (::ftruncate(fd_, 0) != 0 || ::fsync(fd_) != 0) {
+            Logger::getInstance().log("Failed to truncate journal file: " + filename_, LogLevel::Error);
+            return false;
+        }
+        return true;
+    }
+    // Nhật ký không mở (chế độ journal đã tắt): xóa file nếu còn sót lại
+    std::remove(filename_.c_str());
+    return true;
+}
@@ -0,0 +1,59 @@
+#ifndef STUDENT_JOURNAL_HPP_
+#define STUDENT_JOURNAL_HPP_
+
+#include <string>
+#include <functional>
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+// Nhật ký ghi trước (write-ahead journal) cho dữ liệu sinh viên.
+// Mỗi thay đổi được ghi thành một dòng JSON gọn ở cuối file; các bản ghi được
+// gom lại và fsync theo nhóm thay vì ghi lại toàn bộ students.json mỗi lần.
+class StudentJournal {
+public:
+    explicit StudentJournal(const std::string& filename);
+    ~StudentJournal();
+
+    // Mở file nhật ký để ghi nối tiếp; fsync sau mỗi `groupCommitSize` bản ghi
+    bool open(size_t groupCommitSize);
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    // Thêm một bản ghi vào bộ đệm (được ghi xuống đĩa khi đủ nhóm hoặc khi sync())
+    bool append(const json& record);
+
+    // Ghi các bản ghi đang chờ và fsync file nhật ký
+    bool sync();
+
+    // Đọc lại toàn bộ nhật ký theo thứ tự. Dòng cuối chưa có ký tự xuống dòng (ghi dở khi
+    // crash) được cắt bỏ. Một dòng hỏng đã ghi xong thì dừng lại, giữ nguyên file và đánh dấu
+    // nhật ký là hỏng (xem damaged()). Trả về số bản ghi đã áp dụng.
+    size_t replay(const std::function<void(const json&)>& apply);
+
+    // Lần replay() gần nhất gặp bản ghi hỏng giữa nhật ký: append()/reset() bị từ chối để
+    // file được giữ nguyên cho tới khi được sửa và replay() lại thành công
+    bool damaged() const { return damaged_; }
+
+    // Xóa rỗng nhật ký sau khi đã gộp vào snapshot
+    bool reset();
+
+    // Số bản ghi hiện có trong nhật ký (kể cả đang chờ ghi)
+    size_t recordCount() const { return records_; }
+
+    const std::string& getFilename() const { return filename_; }
+
+private:
+    StudentJournal(const StudentJournal&) = delete;
+    StudentJournal& operator=(const StudentJournal&) = delete;
+
+    std::string filename_;
+    int fd_ = -1;
+    size_t groupCommitSize_ = 1;
+    size_t pending_ = 0;
+    size_t records_ = 0;
+    bool damaged_ = false;
+    std::string buffer_;
+};
+
+#endif // STUDENT_JOURNAL_HPP_
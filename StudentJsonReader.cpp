@@ -0,0 +1,269 @@
+#include "StudentJsonReader.hpp"
+#include "Student.hpp"
+#include "AtomicFile.hpp"
+#include <cerrno>
+#include <istream>
+#include <streambuf>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+
+const size_t kReadChunkSize = 1 << 20;
+
+// Các trường của một sinh viên trong students.json, theo thứ tự tham số của constructor
+enum JsonField { Id, Name, Dob, Gender, Faculty, Course, Program, Address, Email, Phone, Status, CreationTime,
+                 FieldCount, Unknown = FieldCount };
+
+const char* const kFieldNames[FieldCount] = {"id", "name", "dob", "gender", "faculty", "course", "program",
+                                             "address", "email", "phone", "status", "creationTime"};
+
+JsonField jsonFieldOf(const std::string& key) {
+    for (int field = 0; field < FieldCount; ++field) {
+        if (key == kFieldNames[field]) {
+            return static_cast<JsonField>(field);
+        }
+    }
+    return Unknown;
+}
+
+// streambuf đọc file theo khối bằng read(); báo tiến độ và cập nhật tóm tắt mỗi khi nạp khối mới
+class ChunkedFileBuf : public std::streambuf {
+public:
+    ChunkedFileBuf(int fd, std::function<void(size_t bytesRead)> onChunk)
+      : fd_(fd), onChunk_(std::move(onChunk)), buffer_(kReadChunkSize) {}
+
+    // Tóm tắt các byte đã đọc; đủ cả file khi underflow() đã trả về eof
+    const FileDigest& digest() const { return digest_; }
+    bool atEnd() const { return atEnd_; }
+
+protected:
+    int_type underflow() override {
+        ssize_t n;
+        do {
+            n = ::read(fd_, buffer_.data(), buffer_.size());
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) {
+            atEnd_ = n == 0;
+            return traits_type::eof();
+        }
+        digest_.update(buffer_.data(), static_cast<size_t>(n));
+        bytesRead_ += static_cast<size_t>(n);
+        onChunk_(bytesRead_);
+        setg(buffer_.data(), buffer_.data(), buffer_.data() + n);
+        return traits_type::to_int_type(buffer_[0]);
+    }
+
+private:
+    int fd_;
+    size_t bytesRead_ = 0;
+    bool atEnd_ = false;
+    std::function<void(size_t)> onChunk_;
+    std::vector<char> buffer_;
+    FileDigest digest_;
+};
+
+// Nhận sự kiện SAX và ghép thành Student. Độ sâu 1 là mảng gốc, độ sâu 2 là đối tượng
+// sinh viên; mọi thứ sâu hơn thuộc một khóa lạ và bị bỏ qua.
+class StudentSaxHandler : public nlohmann::json_sax<json> {
+public:
+    StudentSaxHandler(const std::function<void(Student&&)>& onStudent, std::pmr::memory_resource* resource)
+      : onStudent_(onStudent), alloc_(resource) {}
+
+    // Đọc JSON Lines: mỗi giá trị gốc là một sinh viên, như thể nằm trong mảng gốc
+    void beginRecordSequence() { depth_ = 1; }
+
+    size_t students() const { return students_; }
+    const std::string& error() const { return error_; }
+
+    bool null() override { return scalar(std::string()); }
+    bool boolean(bool val) override { return scalar(val ? "true" : "false"); }
+    bool number_integer(number_integer_t val) override { return scalar(std::to_string(val)); }
+    bool number_unsigned(number_unsigned_t val) override { return scalar(std::to_string(val)); }
+    bool number_float(number_float_t, const string_t& s) override { return scalar(s); }
+    bool binary(binary_t&) override { return scalar(std::string()); }
+
+    bool string(string_t& val) override {
+        if (depth_ == 2 && field_ != Unknown) {
+            fields_[field_].assign(val); // Giữ dung lượng cũ: không cấp phát lại cho mỗi sinh viên
+            seen_[field_] = true;
+            return true;
+        }
+        return scalar(std::string());
+    }
+
+    bool start_object(std::size_t) override {
+        if (depth_ == 0) {
+            return fail("students.json must contain an array of students");
+        }
+        if (depth_ == 1) {
+            for (bool& seen : seen_) seen = false;
+        }
+        ++depth_;
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (depth_ == 2) {
+            field_ = jsonFieldOf(val);
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        --depth_;
+        if (depth_ == 1) {
+            return emitStudent();
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (depth_ == 1) {
+            return fail("student record " + std::to_string(students_ + 1) + " is not an object");
+        }
+        ++depth_;
+        return true;
+    }
+
+    bool end_array() override {
+        --depth_;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        return fail(ex.what());
+    }
+
+private:
+    // Giá trị không phải chuỗi: trong đối tượng sinh viên thì lưu dạng văn bản
+    bool scalar(const std::string& text) {
+        if (depth_ <= 1) {
+            return fail(depth_ == 0 ? "students.json must contain an array of students"
+                                    : "student record " + std::to_string(students_ + 1) + " is not an object");
+        }
+        if (depth_ == 2 && field_ != Unknown) {
+            fields_[field_] = text;
+            seen_[field_] = true;
+        }
+        return true;
+    }
+
+    bool emitStudent() {
+        if (!seen_[Id]) {
+            return fail("student record " + std::to_string(students_ + 1) + " has no \"id\"");
+        }
+        Student student(fields_[Id], fields_[Name], fields_[Dob], fields_[Gender], fields_[Faculty],
+                        fields_[Course], fields_[Program], fields_[Address], fields_[Email], fields_[Phone],
+                        fields_[Status], alloc_);
+        if (seen_[CreationTime]) {
+            student.setCreationTime(iso8601ToTimePoint(fields_[CreationTime]));
+        }
+        for (int field = 0; field < FieldCount; ++field) {
+            fields_[field].clear();
+        }
+        ++students_;
+        onStudent_(std::move(student));
+        return true;
+    }
+
+    bool fail(const std::string& message) {
+        if (error_.empty()) {
+            error_ = message;
+        }
+        return false;
+    }
+
+    const std::function<void(Student&&)>& onStudent_;
+    Student::allocator_type alloc_;
+    std::string fields_[FieldCount];
+    bool seen_[FieldCount] = {};
+    JsonField field_ = Unknown;
+    int depth_ = 0;
+    size_t students_ = 0;
+    std::string error_;
+};
+
+} // namespace
+
+bool readStudentJson(const std::string& filename, const std::function<void(Student&&)>& onStudent,
+                     const JsonLoadProgress& onProgress, std::pmr::memory_resource* resource,
+                     std::string* error, bool* verified) {
+    if (verified) *verified = false;
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (error) *error = "could not open " + filename;
+        return false;
+    }
+    struct stat st;
+    size_t totalBytes = ::fstat(fd, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+
+    StudentSaxHandler handler(onStudent, resource);
+    ChunkedFileBuf buffer(fd, [&](size_t bytesRead) {
+        if (onProgress) onProgress(bytesRead, totalBytes, handler.students());
+    });
+    std::istream input(&buffer);
+    bool ok = true;
+    input >> std::ws;
+    if (input.peek() == '{') {
+        // JSON Lines: các đối tượng sinh viên nối tiếp nhau, không có mảng bao ngoài
+        handler.beginRecordSequence();
+        while (ok && input.peek() != std::char_traits<char>::eof()) {
+            ok = json::sax_parse(input, &handler, json::input_format_t::json, false);
+            input >> std::ws;
+        }
+    } else if (input.peek() != std::char_traits<char>::eof()) { // File rỗng: không có sinh viên nào
+        ok = json::sax_parse(input, &handler);
+    }
+    ::close(fd);
+
+    if (ok && onProgress) {
+        onProgress(totalBytes, totalBytes, handler.students());
+    }
+    if (!ok) {
+        if (error) *error = handler.error();
+        Logger::getInstance().log("Failed to parse " + filename + ": " + handler.error(), LogLevel::Error);
+    } else if (verified) {
+        // Sau giá trị JSON cuối, `input >> std::ws` đã đọc tới cuối file
+        *verified = buffer.atEnd() && digestMatches(filename, buffer.digest());
+    }
+    return ok;
+}
+
+bool studentFieldsFromJson(const json& record, std::vector<std::string>& fields) {
+    fields.clear();
+    if (!record.is_object() || !record.contains("id")) {
+        return false;
+    }
+    for (const char* name : kFieldNames) {
+        auto value = record.find(name);
+        if (value == record.end()) {
+            fields.emplace_back();
+            continue;
+        }
+        // Như các sự kiện SAX của StudentSaxHandler
+        switch (value->type()) {
+        case json::value_t::string:
+            fields.push_back(value->get<std::string>());
+            break;
+        case json::value_t::boolean:
+            fields.emplace_back(value->get<bool>() ? "true" : "false");
+            break;
+        case json::value_t::number_integer:
+            fields.push_back(std::to_string(value->get<json::number_integer_t>()));
+            break;
+        case json::value_t::number_unsigned:
+            fields.push_back(std::to_string(value->get<json::number_unsigned_t>()));
+            break;
+        case json::value_t::number_float:
+            fields.push_back(value->dump());
+            break;
+        default:
+            fields.emplace_back();
+            break;
+        }
+    }
+    return true;
+}
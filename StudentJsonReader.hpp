@@ -0,0 +1,43 @@
+#ifndef STUDENT_JSON_READER_HPP_
+#define STUDENT_JSON_READER_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+class Student;
+
+// Đọc students.json theo kiểu SAX: file được đọc theo khối và mỗi sinh viên được tạo ngay
+// khi đọc xong đối tượng của nó, không dựng cây JSON của cả file. Bộ nhớ dùng thêm chỉ gồm
+// một khối đọc và các trường của sinh viên đang đọc. Nhận mọi kiểu ghi của dumpJson: mảng
+// các đối tượng (pretty/compact) hoặc JSON Lines (mỗi dòng một đối tượng); file rỗng là
+// danh sách rỗng.
+//
+// Khóa không thuộc Student (và giá trị lồng nhau) được bỏ qua; trường số được đọc như chuỗi;
+// thiếu "creationTime" thì lấy thời điểm hiện tại. Mỗi đối tượng phải có "id".
+
+// Gọi sau mỗi khối đọc: số byte đã đọc, kích thước file, số sinh viên đã tạo
+using JsonLoadProgress = std::function<void(size_t bytesRead, size_t totalBytes, size_t students)>;
+
+// Gọi `onStudent` cho từng sinh viên theo thứ tự trong file; chuỗi của sinh viên được cấp phát
+// từ `resource`. Trả về false nếu không mở được file hoặc file sai cú pháp/cấu trúc; khi đó
+// `error` (nếu có) chứa mô tả lỗi và các sinh viên đã gửi trước lỗi không được rút lại.
+// `verified` (nếu có): nội dung vừa đọc khớp file tóm tắt do writeFileAtomicWithDigest ghi,
+// tức file đúng là bản chương trình đã lưu; tóm tắt được tính trong cùng lượt đọc.
+bool readStudentJson(const std::string& filename, const std::function<void(Student&&)>& onStudent,
+                     const JsonLoadProgress& onProgress = nullptr,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                     std::string* error = nullptr, bool* verified = nullptr);
+
+// Đổi một đối tượng sinh viên đã phân tích (ví dụ một dòng NDJSON) thành các trường theo thứ
+// tự của getAllStudentsAsStrings, thêm "creationTime" ở cuối, với cùng quy tắc như
+// readStudentJson: số và bool thành văn bản, null/giá trị lồng nhau/khóa thiếu thành chuỗi
+// rỗng, khóa lạ bị bỏ qua. Trả về false nếu `record` không phải đối tượng hoặc thiếu "id".
+bool studentFieldsFromJson(const json& record, std::vector<std::string>& fields);
+
+#endif // STUDENT_JSON_READER_HPP_
@@ -0,0 +1,190 @@
+#include "StudentQuery.hpp"
+#include <cctype>
+
+namespace {
+
+struct FieldName {
+    const char* name;
+    StudentField field;
+};
+
+const FieldName kFieldNames[] = {
+    {"id", StudentField::Id},           {"name", StudentField::Name},
+    {"dob", StudentField::Dob},         {"gender", StudentField::Gender},
+    {"faculty", StudentField::Faculty}, {"course", StudentField::Course},
+    {"program", StudentField::Program}, {"address", StudentField::Address},
+    {"email", StudentField::Email},     {"phone", StudentField::Phone},
+    {"status", StudentField::Status},
+};
+
+std::string toLower(std::string s) {
+    for (char& c : s) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return s;
+}
+
+// Bộ đọc token đơn giản trên chuỗi truy vấn
+class QueryLexer {
+public:
+    explicit QueryLexer(const std::string& text) : text_(text) {}
+
+    bool atEnd() {
+        skipSpaces();
+        return pos_ >= text_.size();
+    }
+
+    // Tên trường hoặc từ khóa: chữ, số, '_'
+    std::string word() {
+        skipSpaces();
+        size_t start = pos_;
+        while (pos_ < text_.size() &&
+               (std::isalnum(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '_')) {
+            ++pos_;
+        }
+        return text_.substr(start, pos_ - start);
+    }
+
+    bool op(QueryOp& result) {
+        skipSpaces();
+        static const struct { const char* text; QueryOp op; } kOps[] = {
+            {"==", QueryOp::Equal}, {"!=", QueryOp::NotEqual}, {"<>", QueryOp::NotEqual},
+            {">=", QueryOp::GreaterEqual}, {"<=", QueryOp::LessEqual},
+            {"=", QueryOp::Equal}, {">", QueryOp::Greater}, {"<", QueryOp::Less}, {"~", QueryOp::Contains},
+        };
+        for (const auto& candidate : kOps) {
+            if (text_.compare(pos_, std::char_traits<char>::length(candidate.text), candidate.text) == 0) {
+                pos_ += std::char_traits<char>::length(candidate.text);
+                result = candidate.op;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Giá trị: chuỗi trong nháy đơn/kép hoặc một dãy ký tự không có khoảng trắng
+    bool value(std::string& result, std::string& error) {
+        skipSpaces();
+        result.clear();
+        if (pos_ >= text_.size()) {
+            error = "Thiếu giá trị sau toán tử.";
+            return false;
+        }
+        char quote = text_[pos_];
+        if (quote == '\'' || quote == '"') {
+            ++pos_;
+            while (pos_ < text_.size()) {
+                if (text_[pos_] == quote) {
+                    if (pos_ + 1 < text_.size() && text_[pos_ + 1] == quote) {
+                        result += quote;
+                        pos_ += 2;
+                        continue;
+                    }
+                    ++pos_;
+                    return true;
+                }
+                result += text_[pos_++];
+            }
+            error = "Thiếu dấu nháy đóng.";
+            return false;
+        }
+        while (pos_ < text_.size() && !std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            result += text_[pos_++];
+        }
+        return true;
+    }
+
+private:
+    void skipSpaces() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+    }
+
+    const std::string& text_;
+    size_t pos_ = 0;
+};
+
+bool parseCount(const std::string& text, size_t& result) {
+    if (text.empty()) {
+        return false;
+    }
+    result = 0;
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            return false;
+        }
+        result = result * 10 + static_cast<size_t>(c - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+bool parseStudentField(const std::string& name, StudentField& field) {
+    std::string lower = toLower(name);
+    for (const FieldName& entry : kFieldNames) {
+        if (lower == entry.name) {
+            field = entry.field;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* studentFieldName(StudentField field) {
+    for (const FieldName& entry : kFieldNames) {
+        if (entry.field == field) {
+            return entry.name;
+        }
+    }
+    return "";
+}
+
+bool parseStudentQuery(const std::string& text, StudentQuery& query, std::string& error) {
+    query = StudentQuery();
+    QueryLexer lexer(text);
+    bool expectPredicate = true;
+    while (!lexer.atEnd()) {
+        std::string word = lexer.word();
+        std::string keyword = toLower(word);
+        if (keyword == "limit" || keyword == "offset") {
+            std::string count;
+            size_t value;
+            if (!lexer.value(count, error) || !parseCount(count, value)) {
+                error = "Giá trị " + word + " phải là số nguyên không âm.";
+                return false;
+            }
+            (keyword == "limit" ? query.limit : query.offset) = value;
+            expectPredicate = false;
+            continue;
+        }
+        if (!expectPredicate) {
+            if (keyword != "and" || query.predicates.empty()) {
+                error = "Cần 'AND' giữa các điều kiện (gặp '" + word + "').";
+                return false;
+            }
+            expectPredicate = true;
+            continue;
+        }
+        QueryPredicate predicate;
+        if (word.empty() || !parseStudentField(word, predicate.field)) {
+            error = "Trường không hợp lệ: '" + word + "'.";
+            return false;
+        }
+        if (!lexer.op(predicate.op)) {
+            error = "Thiếu toán tử so sánh sau '" + word + "' (=, !=, <, <=, >, >=, ~).";
+            return false;
+        }
+        if (!lexer.value(predicate.value, error)) {
+            return false;
+        }
+        query.predicates.push_back(std::move(predicate));
+        expectPredicate = false;
+    }
+    if (expectPredicate && !query.predicates.empty()) {
+        error = "Thiếu điều kiện sau 'AND'.";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef STUDENT_QUERY_HPP_
+#define STUDENT_QUERY_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Các trường của sinh viên có thể dùng trong truy vấn (tên trùng khóa JSON)
+enum class StudentField { Id, Name, Dob, Gender, Faculty, Course, Program, Address, Email, Phone, Status };
+
+enum class QueryOp {
+    Equal,        // =  (hoặc ==)
+    NotEqual,     // != (hoặc <>)
+    Less,         // <
+    LessEqual,    // <=
+    Greater,      // >
+    GreaterEqual, // >=
+    Contains      // ~  chứa chuỗi con, không phân biệt hoa thường/dấu
+};
+
+struct QueryPredicate {
+    StudentField field;
+    QueryOp op;
+    std::string value;
+};
+
+// Truy vấn: các điều kiện nối bằng AND, cùng LIMIT/OFFSET trên kết quả (theo thứ tự lưu trữ)
+struct StudentQuery {
+    std::vector<QueryPredicate> predicates;
+    size_t limit = SIZE_MAX;
+    size_t offset = 0;
+};
+
+// Thông tin thực thi: chỉ mục đã chọn và số bản ghi phải kiểm tra
+struct QueryStats {
+    std::string index = "scan";
+    size_t candidates = 0;
+};
+
+// Tên trường (không phân biệt hoa thường) -> StudentField
+bool parseStudentField(const std::string& name, StudentField& field);
+const char* studentFieldName(StudentField field);
+
+// Phân tích truy vấn dạng:
+//   status=Active AND course>=2020 AND program='High Quality Program' LIMIT 20 OFFSET 40
+// Giá trị có khoảng trắng đặt trong '...' hoặc "..." (nháy kép hai lần để viết dấu nháy).
+// Trả về false và ghi lý do vào `error` nếu truy vấn không hợp lệ.
+bool parseStudentQuery(const std::string& text, StudentQuery& query, std::string& error);
+
+#endif // STUDENT_QUERY_HPP_
@@ -0,0 +1,279 @@
+#include "StudentSnapshot.hpp"
+#include "Student.hpp"
+#include "StudentJsonReader.hpp"
+#include "AtomicFile.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char kMagic[4] = {'S', 'M', 'S', 'B'};
+const char kFooterMagic[4] = {'S', 'M', 'S', 'E'};
+const size_t kHeaderSize = 4 + 4 + 8 + 8;
+const size_t kFooterSize = 4 + 8;
+// Bản ghi ngắn nhất: 4 mã, thời điểm tạo và 7 chuỗi rỗng (chỉ có độ dài)
+const size_t kMinRecordSize = 4 * 4 + 8 + 7 * 4;
+const size_t kMinTableEntrySize = 4;
+
+uint64_t checksum(uint64_t hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+const uint64_t kChecksumSeed = 14695981039346656037ULL;
+
+void putU32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+}
+
+void putU64(std::string& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+}
+
+void putString(std::string& out, std::string_view s) {
+    putU32(out, static_cast<uint32_t>(s.size()));
+    out.append(s);
+}
+
+// Con trỏ đọc có kiểm tra giới hạn trên vùng nhớ đã mmap
+class Cursor {
+public:
+    Cursor(const char* p, const char* end) : p_(p), end_(end) {}
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return p_ == end_; }
+    size_t remaining() const { return static_cast<size_t>(end_ - p_); }
+
+    uint32_t u32() {
+        if (!need(4)) return 0;
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(static_cast<unsigned char>(p_[i])) << (8 * i);
+        p_ += 4;
+        return v;
+    }
+
+    uint64_t u64() {
+        if (!need(8)) return 0;
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(static_cast<unsigned char>(p_[i])) << (8 * i);
+        p_ += 8;
+        return v;
+    }
+
+    // Chuỗi trỏ thẳng vào vùng nhớ đã mmap (chỉ dùng trong lúc đọc)
+    std::string_view str() {
+        uint32_t length = u32();
+        if (!need(length)) return std::string_view();
+        std::string_view s(p_, length);
+        p_ += length;
+        return s;
+    }
+
+private:
+    bool need(size_t n) {
+        if (!ok_ || static_cast<size_t>(end_ - p_) < n) {
+            ok_ = false;
+            return false;
+        }
+        return true;
+    }
+
+    const char* p_;
+    const char* end_;
+    bool ok_ = true;
+};
+
+// Bảng chuỗi dùng chung cho các trường có ít giá trị khác nhau
+class StringTable {
+public:
+    uint32_t intern(const std::string& value) {
+        auto it = codes_.find(value);
+        if (it != codes_.end()) return it->second;
+        uint32_t code = static_cast<uint32_t>(values_.size());
+        codes_.emplace(value, code);
+        values_.push_back(value);
+        return code;
+    }
+
+    const std::vector<std::string>& values() const { return values_; }
+
+private:
+    std::unordered_map<std::string, uint32_t> codes_;
+    std::vector<std::string> values_;
+};
+
+bool parseSnapshot(const char* data, size_t size, std::vector<Student>& students,
+                   std::pmr::memory_resource* resource) {
+    if (size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    Cursor header(data + 4, data + kHeaderSize);
+    uint32_t version = header.u32();
+    uint64_t count = header.u64();
+    uint64_t payloadBytes = header.u64();
+    size_t footerSize = version >= 2 ? kFooterSize : 0;
+    if (version < 1 || version > kStudentSnapshotVersion || size - kHeaderSize < footerSize ||
+        payloadBytes != size - kHeaderSize - footerSize) {
+        return false;   // Phiên bản khác hoặc file bị cắt cụt
+    }
+    if (count > payloadBytes / kMinRecordSize) {
+        return false;   // Số bản ghi không thể vừa trong payload: không cấp phát theo nó
+    }
+    const char* payloadEnd = data + kHeaderSize + payloadBytes;
+    if (footerSize > 0) {
+        Cursor footer(payloadEnd + 4, data + size);
+        if (std::memcmp(payloadEnd, kFooterMagic, sizeof(kFooterMagic)) != 0 ||
+            footer.u64() != checksum(kChecksumSeed, data, kHeaderSize + payloadBytes)) {
+            return false;   // Nội dung không khớp checksum
+        }
+    }
+
+    Cursor in(data + kHeaderSize, payloadEnd);
+    uint32_t tableCount = in.u32();
+    if (!in.ok() || tableCount > in.remaining() / kMinTableEntrySize) {
+        return false;
+    }
+    std::vector<std::string_view> table(tableCount);
+    for (auto& value : table) {
+        value = in.str();
+    }
+    auto lookup = [&](uint32_t code) {
+        return code < table.size() ? table[code] : std::string_view();
+    };
+
+    std::vector<Student> loaded;
+    loaded.reserve(static_cast<size_t>(count));
+    for (uint64_t i = 0; i < count && in.ok(); ++i) {
+        std::string_view faculty = lookup(in.u32());
+        std::string_view program = lookup(in.u32());
+        std::string_view status = lookup(in.u32());
+        std::string_view gender = lookup(in.u32());
+        std::time_t created = static_cast<std::time_t>(static_cast<int64_t>(in.u64()));
+        std::string_view id = in.str();
+        std::string_view name = in.str();
+        std::string_view dob = in.str();
+        std::string_view course = in.str();
+        std::string_view address = in.str();
+        std::string_view email = in.str();
+        std::string_view phone = in.str();
+        loaded.emplace_back(id, name, dob, gender, faculty, course, program, address, email, phone, status,
+                            Student::allocator_type(resource));
+        loaded.back().setCreationTime(std::chrono::system_clock::from_time_t(created));
+    }
+    if (!in.ok() || !in.atEnd()) {
+        return false;
+    }
+    students.swap(loaded);
+    return true;
+}
+
+// `students` là vector<Student> hoặc vector<StudentPtr>; `row` lấy ra Student của một phần tử
+template <typename Rows, typename Row>
+std::string encodeSnapshot(const Rows& students, Row row) {
+    StringTable table;
+    std::string records;
+    for (const auto& element : students) {
+        const Student& student = row(element);
+        putU32(records, table.intern(student.getFaculty()));
+        putU32(records, table.intern(student.getProgram()));
+        putU32(records, table.intern(student.getStatus()));
+        putU32(records, table.intern(student.getGender()));
+        putU64(records, static_cast<uint64_t>(static_cast<int64_t>(
+            std::chrono::system_clock::to_time_t(student.getCreationTime()))));
+        putString(records, student.getIdView());
+        putString(records, student.getNameView());
+        putString(records, student.getDobView());
+        putString(records, student.getCourseView());
+        putString(records, student.getAddressView());
+        putString(records, student.getEmailView());
+        putString(records, student.getPhoneView());
+    }
+
+    std::string payload;
+    putU32(payload, static_cast<uint32_t>(table.values().size()));
+    for (const auto& value : table.values()) {
+        putString(payload, value);
+    }
+    payload += records;
+
+    std::string header(kMagic, sizeof(kMagic));
+    putU32(header, kStudentSnapshotVersion);
+    putU64(header, students.size());
+    putU64(header, payload.size());
+
+    std::string footer(kFooterMagic, sizeof(kFooterMagic));
+    putU64(footer, checksum(checksum(kChecksumSeed, header.data(), header.size()), payload.data(), payload.size()));
+    header.reserve(header.size() + payload.size() + footer.size());
+    header += payload;
+    header += footer;
+    return header;
+}
+
+} // namespace
+
+std::string encodeStudentSnapshot(const std::vector<Student>& students) {
+    return encodeSnapshot(students, [](const Student& student) -> const Student& { return student; });
+}
+
+std::string encodeStudentSnapshot(const std::vector<StudentPtr>& students) {
+    return encodeSnapshot(students, [](const StudentPtr& student) -> const Student& { return *student; });
+}
+
+bool writeStudentSnapshot(const std::string& filename, const std::vector<Student>& students) {
+    return writeFileAtomic(filename, encodeStudentSnapshot(students));
+}
+
+bool readStudentSnapshot(const std::string& filename, std::vector<Student>& students,
+                         std::pmr::memory_resource* resource) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    bool ok = false;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        size_t size = static_cast<size_t>(st.st_size);
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            ::madvise(mapped, size, MADV_SEQUENTIAL);
+            ok = parseSnapshot(static_cast<const char*>(mapped), size, students, resource);
+            ::munmap(mapped, size);
+        }
+    }
+    ::close(fd);
+    if (!ok) {
+        Logger::getInstance().log("Invalid or corrupt student snapshot: " + filename, LogLevel::Error);
+    }
+    return ok;
+}
+
+bool convertJsonToSnapshot(const std::string& jsonFilename, const std::string& snapshotFilename) {
+    std::vector<Student> students;
+    std::string error;
+    if (!readStudentJson(jsonFilename, [&](Student&& student) { students.push_back(std::move(student)); },
+                         nullptr, std::pmr::get_default_resource(), &error)) {
+        std::cerr << "Error reading JSON file " << jsonFilename << ": " << error << std::endl;
+        return false;
+    }
+    return writeStudentSnapshot(snapshotFilename, students);
+}
+
+bool convertSnapshotToJson(const std::string& snapshotFilename, const std::string& jsonFilename) {
+    std::vector<Student> students;
+    if (!readStudentSnapshot(snapshotFilename, students)) {
+        std::cerr << "Error: Could not read snapshot file: " << snapshotFilename << std::endl;
+        return false;
+    }
+    json j = json::array();
+    for (const auto& student : students) {
+        j.push_back(student.toJson());
+    }
+    return writeFileAtomicWithDigest(jsonFilename, dumpJson(j, ConfigManager::getInstance().getJsonOutputStyle()));
+}
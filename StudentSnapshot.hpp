@@ -0,0 +1,45 @@
+#ifndef STUDENT_SNAPSHOT_HPP_
+#define STUDENT_SNAPSHOT_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <memory_resource>
+
+class Student;
+// Bản ghi sinh viên bất biến, dùng chung giữa repository và các snapshot ghi nền
+using StudentPtr = std::shared_ptr<const Student>;
+
+// Định dạng snapshot nhị phân cho dữ liệu sinh viên (students.bin).
+//
+// Bố cục (số nguyên little-endian):
+//   header   : magic "SMSB", u32 version, u64 số sinh viên, u64 số byte phần dữ liệu
+//   strings  : u32 số chuỗi, rồi từng chuỗi (u32 độ dài + byte) – bảng giá trị
+//              dùng chung của Khoa/Chương trình/Tình trạng/Giới tính
+//   records  : mỗi sinh viên gồm 4 chỉ số u32 vào bảng chuỗi (khoa, chương trình,
+//              tình trạng, giới tính), i64 creationTime (giây Unix), rồi 7 chuỗi
+//              có tiền tố độ dài: MSSV, họ tên, ngày sinh, khóa, địa chỉ, email, SĐT
+//   footer   : magic "SMSE", u64 FNV-1a của header và phần dữ liệu (từ phiên bản 2)
+//
+// File được mmap khi đọc và các trường được lấy thẳng từ vùng nhớ, không cần
+// phân tích cú pháp như JSON. File được ghi bằng writeFileAtomic; khi đọc, checksum ở
+// footer phải khớp, nên file ghi dở hoặc bị hỏng không bao giờ được nạp. File phiên bản 1
+// (không có footer) vẫn đọc được.
+
+const unsigned kStudentSnapshotVersion = 2;
+
+// Nội dung file snapshot của `students` (để tuần tự hóa và ghi file ở hai bước riêng)
+std::string encodeStudentSnapshot(const std::vector<Student>& students);
+std::string encodeStudentSnapshot(const std::vector<StudentPtr>& students);
+bool writeStudentSnapshot(const std::string& filename, const std::vector<Student>& students);
+
+// Đọc snapshot; trả về false (và giữ nguyên `students`) nếu file không tồn tại hoặc hỏng.
+// Chuỗi của các sinh viên được cấp phát từ `resource` (ví dụ: arena của repository).
+bool readStudentSnapshot(const std::string& filename, std::vector<Student>& students,
+                         std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+// Chuyển đổi giữa students.json và snapshot nhị phân
+bool convertJsonToSnapshot(const std::string& jsonFilename, const std::string& snapshotFilename);
+bool convertSnapshotToJson(const std::string& snapshotFilename, const std::string& jsonFilename);
+
+#endif // STUDENT_SNAPSHOT_HPP_
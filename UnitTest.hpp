@@ -1,6 +1,11 @@
 #ifndef UNIT_TEST_HPP_
 #define UNIT_TEST_HPP_
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 namespace Test {
     // Hàm hỗ trợ xóa sạch danh sách sinh viên (nếu cần)
     void clearStudentRepository() {
@@ -44,7 +49,7 @@ namespace Test {
                   "+84123456789", "Active");
 
         repo.addStudent(s);
-        Student* found = repo.findStudent("SV001");
+        const Student* found = repo.findStudent("SV001");
         assert(found != nullptr);
         assert(found->getName() == "Alice");
 
@@ -56,12 +61,897 @@ namespace Test {
 
         // Xóa sinh viên
         repo.removeStudent("SV001");
-        Student* foundAfterRemove = repo.findStudent("SV001");
+        const Student* foundAfterRemove = repo.findStudent("SV001");
         assert(foundAfterRemove == nullptr);
 
         std::cout << "testStudentRepository passed.\n";
     }
 
+    // Test: Chỉ mục MSSV luôn đồng bộ khi thêm, đổi MSSV và xóa sinh viên
+    void testStudentIdIndex() {
+        StudentRepository& repo = StudentRepository::getInstance();
+
+        Student a("SV101", "Alice", "01/01/2000", "Female", "Faculty of Law", "2020",
+                  "Advanced Program", "Address 1", "alice@student.university.edu.vn",
+                  "+84123456789", "Active");
+        Student b("SV102", "Bob", "02/02/2000", "Male", "Faculty of Law", "2020",
+                  "Formal Program", "Address 2", "bob@student.university.edu.vn",
+                  "+84987654321", "Active");
+        repo.addStudent(a);
+        repo.addStudent(b);
+        assert(repo.isStudentIdExists("SV101") && repo.isStudentIdExists("SV102"));
+
+        // Đổi MSSV: khóa cũ biến mất, khóa mới trỏ đúng sinh viên
+        Student renamed = *repo.findStudent("SV101");
+        renamed.setId("SV103");
+        assert(repo.updateStudent("SV101", renamed));
+        assert(repo.findStudent("SV101") == nullptr);
+        assert(repo.findStudent("SV103")->getName() == "Alice");
+
+        // Không cho đổi sang MSSV đã tồn tại
+        Student clash = *repo.findStudent("SV103");
+        clash.setId("SV102");
+        assert(!repo.updateStudent("SV103", clash));
+
+        // Xóa phần tử giữa danh sách: các phần tử còn lại vẫn tra cứu được
+        repo.removeStudent("SV103");
+        assert(repo.findStudent("SV103") == nullptr);
+        assert(repo.findStudent("SV102")->getName() == "Bob");
+        repo.removeStudent("SV102");
+        assert(!repo.isStudentIdExists("SV102"));
+
+        std::cout << "testStudentIdIndex passed.\n";
+    }
+
+    // Test: Chỉ mục phụ theo khoa/khóa luôn khớp dữ liệu sau thêm, sửa, đổi tên, xóa
+    void testStudentSecondaryIndex() {
+        StudentRepository& repo = StudentRepository::getInstance();
+        repo.addFaculty("FIDX");
+
+        Student a("SV111", "Alice", "01/01/2000", "Female", "FIDX", "2021",
+                  "Advanced Program", "Address 1", "alice@student.university.edu.vn",
+                  "+84123456789", "Active");
+        Student b("SV112", "Bob", "02/02/2000", "Male", "FIDX", "2021",
+                  "Formal Program", "Address 2", "bob@student.university.edu.vn",
+                  "+84987654321", "Active");
+        repo.addStudent(a);
+        repo.addStudent(b);
+        assert(repo.searchStudents("FIDX").size() == 2);
+        assert(repo.searchStudents("FIDX", "Bob").size() == 1);
+        assert(!repo.deleteFaculty("FIDX"));
+
+        // Đổi tên khoa: chỉ mục chuyển toàn bộ sang tên mới
+        repo.renameFaculty("FIDX", "FIDX2");
+        assert(repo.countByFaculty("FIDX") == 0);
+        assert(repo.countByFaculty("FIDX2") == 2);
+        assert(repo.findStudent("SV111")->getFaculty() == "FIDX2");
+
+        Student edited = *repo.findStudent("SV111");
+        edited.setCourse("2022");
+        assert(repo.updateStudent("SV111", edited));
+        assert(repo.countByCourse("2022") >= 1);
+        assert(repo.searchStudents("FIDX2").size() == 2);
+
+        // Xóa phần tử đầu: phần tử cuối được dời vào chỗ trống vẫn tra cứu được
+        repo.removeStudent("SV111");
+        std::vector<Student> remaining = repo.searchStudents("FIDX2");
+        assert(remaining.size() == 1 && remaining[0].getId() == "SV112");
+        repo.removeStudent("SV112");
+        assert(repo.countByFaculty("FIDX2") == 0);
+        assert(repo.deleteFaculty("FIDX2"));
+
+        std::cout << "testStudentSecondaryIndex passed.\n";
+    }
+
+    // Test: Khoa/chương trình/tình trạng/giới tính được lưu bằng mã; đổi tên chỉ sửa từ điển
+    void testStudentDictionary() {
+        FieldDictionary dictionary;
+        uint32_t code = dictionary.intern("FL");
+        assert(dictionary.intern("FL") == code);
+        assert(dictionary.intern("FBE") != code);
+        assert(dictionary.rename(code, "FLaw") && dictionary.value(code) == "FLaw");
+        assert(!dictionary.rename(code, "FBE"));
+
+        StudentRepository& repo = StudentRepository::getInstance();
+        repo.addFaculty("FDA");
+        Student a("SV121", "Alice", "01/01/2000", "Female", "FDA", "2021",
+                  "Advanced Program", "Address 1", "alice@student.university.edu.vn",
+                  "+84123456789", "Active");
+        Student b("SV122", "Bob", "02/02/2000", "Male", "FDA", "2021",
+                  "Formal Program", "Address 2", "bob@student.university.edu.vn",
+                  "+84987654321", "Active");
+        assert(a.getFacultyCode() == b.getFacultyCode());
+        repo.addStudent(a);
+        repo.addStudent(b);
+
+        // Tên mới chưa có mã: đổi trực tiếp trong từ điển, mã của sinh viên giữ nguyên
+        uint32_t before = repo.findStudent("SV121")->getFacultyCode();
+        repo.renameFaculty("FDA", "FDB");
+        assert(repo.findStudent("SV121")->getFacultyCode() == before);
+        assert(repo.findStudent("SV122")->getFaculty() == "FDB");
+
+        // Tên mới đã có mã riêng (được dùng ở nơi khác): gán lại mã cho từng sinh viên
+        Student other("SV000", "Other", "01/01/2000", "Male", "FDC", "2021",
+                      "Formal Program", "Address", "other@student.university.edu.vn",
+                      "+84123456789", "Active");
+        repo.renameFaculty("FDB", "FDC");
+        assert(repo.findStudent("SV121")->getFacultyCode() == other.getFacultyCode());
+        assert(repo.countByFaculty("FDC") == 2 && repo.countByFaculty("FDB") == 0);
+
+        repo.removeStudent("SV121");
+        repo.removeStudent("SV122");
+        assert(repo.deleteFaculty("FDC"));
+
+        std::cout << "testStudentDictionary passed.\n";
+    }
+
+    // Test: Tìm theo họ tên không phân biệt hoa thường/dấu, chỉ mục cập nhật khi thêm/sửa/xóa
+    void testNameSearchIndex() {
+        assert(foldName("Nguyễn  Văn Ân") == "nguyen van an");
+        assert(foldName("ĐỖ THỊ Hồng-Nhung") == "do thi hong nhung");
+        assert(foldName("Nguye\xcc\x82\xcc\x83n") == "nguyen"); // Dạng tổ hợp (NFD)
+
+        NameSearchIndex index;
+        index.insert(0, "Nguyễn Văn An");
+        index.insert(1, "Trần Thị Nguyệt");
+        index.insert(2, "Lê Văn Anh");
+        assert(index.search("nguyen").size() == 1);
+        assert((index.search("NGUY") == std::vector<size_t>{0, 1}));
+        assert((index.search("an", NameMatchMode::Prefix) == std::vector<size_t>{0, 2}));
+        assert(index.search("van an", NameMatchMode::Prefix).size() == 2);
+        assert(index.search("van anh").size() == 1);
+        assert(index.search("xyz").empty());
+
+        // Xóa vị trí 0 rồi dời vị trí 2 vào chỗ trống (như swap-and-pop của repository)
+        index.erase(0);
+        index.relocate(2, 0);
+        assert((index.search("van") == std::vector<size_t>{0}));
+        assert((index.search("nguy") == std::vector<size_t>{1}));
+
+        StudentRepository& repo = StudentRepository::getInstance();
+        repo.addFaculty("FNS");
+        Student a("SV131", "Phạm Thị Ánh", "01/01/2000", "Female", "FNS", "2021",
+                  "Advanced Program", "Address 1", "anh@student.university.edu.vn",
+                  "+84123456789", "Active");
+        repo.addStudent(a);
+        assert(repo.searchByName("pham thi anh").size() == 1);
+        assert(repo.searchStudents("FNS", "ANH").size() == 1);
+
+        Student edited = *repo.findStudent("SV131");
+        edited.setName("Phạm Thị Bích");
+        assert(repo.updateStudent("SV131", edited));
+        assert(repo.searchByName("Ánh").empty());
+        assert(repo.searchByName("bich", NameMatchMode::Prefix).size() == 1);
+
+        repo.removeStudent("SV131");
+        assert(repo.searchByName("Bích").empty());
+        repo.deleteFaculty("FNS");
+
+        std::cout << "testNameSearchIndex passed.\n";
+    }
+
+    // Test: Tìm gần đúng theo khoảng cách chỉnh sửa trên MSSV và họ tên
+    void testFuzzySearch() {
+        assert(editDistance("kitten", "sitting") == 3);
+        assert(editDistance("", "abc") == 3);
+        assert(editDistance("22127001", "22127001") == 0);
+
+        FuzzyIndex index;
+        index.insert("nguyen van an", "SV1");
+        index.insert("nguyen van anh", "SV2");
+        index.insert("tran thi binh", "SV3");
+        std::vector<FuzzyIndex::Match> matches = index.search("nguyen vn an", 2, 2);
+        assert(matches.size() == 2 && matches[0].key == "SV1" && matches[0].distance == 1);
+        index.erase("nguyen van an", "SV1");
+        matches = index.search("nguyen vn an", 2, 2);
+        assert(matches.size() == 1 && matches[0].key == "SV2");
+
+        StudentRepository& repo = StudentRepository::getInstance();
+        repo.addFaculty("FFZ");
+        Student a("SV14101", "Hoàng Minh Quân", "01/01/2000", "Male", "FFZ", "2021",
+                  "Advanced Program", "Address 1", "quan@student.university.edu.vn",
+                  "+84123456789", "Active");
+        repo.addStudent(a);
+        // Gõ sai một chữ số MSSV / thiếu dấu và sai chính tả họ tên
+        std::vector<Student> results = repo.fuzzySearch("SV14110", 3);
+        assert(!results.empty() && results[0].getId() == "SV14101");
+        results = repo.fuzzySearch("hoang minh quan", 3);
+        assert(!results.empty() && results[0].getId() == "SV14101");
+
+        // Chỉ mục được cập nhật sau khi đã dựng
+        Student b("SV14102", "Hoàng Minh Quang", "01/01/2000", "Male", "FFZ", "2021",
+                  "Advanced Program", "Address 2", "quang@student.university.edu.vn",
+                  "+84123456789", "Active");
+        repo.addStudent(b);
+        results = repo.fuzzySearch("hoang minh quangg", 1);
+        assert(results.size() == 1 && results[0].getId() == "SV14102");
+        repo.removeStudent("SV14101");
+        repo.removeStudent("SV14102");
+        for (const Student& student : repo.fuzzySearch("SV14101", 3)) {
+            assert(student.getId() != "SV14101" && student.getId() != "SV14102");
+        }
+        repo.deleteFaculty("FFZ");
+
+        std::cout << "testFuzzySearch passed.\n";
+    }
+
+    // Test: Phân tích và thực thi truy vấn nhiều điều kiện, chọn chỉ mục nhỏ nhất
+    void testStudentQuery() {
+        StudentQuery query;
+        std::string error;
+        assert(parseStudentQuery("status=Active AND course>=2020 AND program='High Quality Program' LIMIT 5 OFFSET 1",
+                                 query, error));
+        assert(query.predicates.size() == 3 && query.limit == 5 && query.offset == 1);
+        assert(query.predicates[1].field == StudentField::Course && query.predicates[1].op == QueryOp::GreaterEqual);
+        assert(query.predicates[2].value == "High Quality Program");
+        assert(!parseStudentQuery("grade=A", query, error));
+        assert(!parseStudentQuery("status Active", query, error));
+        assert(!parseStudentQuery("status=Active course=2020", query, error));
+        assert(!parseStudentQuery("name='abc", query, error));
+
+        StudentRepository& repo = StudentRepository::getInstance();
+        repo.addFaculty("FQ");
+        const char* names[] = {"Nguyễn Văn An", "Trần Thị Bình", "Lê Văn Cường"};
+        const char* courses[] = {"2019", "2020", "2021"};
+        for (int i = 0; i < 3; ++i) {
+            Student student("SV15" + std::to_string(i), names[i], "01/0" + std::to_string(i + 1) + "/2001", "Male",
+                            "FQ", courses[i], i == 2 ? "High Quality Program" : "Formal Program", "Address",
+                            "q@student.university.edu.vn", "+84123456789", "Active");
+            repo.addStudent(student);
+        }
+
+        QueryStats stats;
+        assert(parseStudentQuery("faculty=FQ AND course>=2020", query, error));
+        std::vector<Student> results = repo.query(query, &stats);
+        assert(results.size() == 2 && stats.index == "faculty" && stats.candidates == 3);
+
+        assert(parseStudentQuery("faculty=FQ AND name~van AND program!='Formal Program'", query, error));
+        results = repo.query(query);
+        assert(results.size() == 1 && results[0].getId() == "SV152");
+
+        assert(parseStudentQuery("id=SV151 AND status=Active", query, error));
+        results = repo.query(query, &stats);
+        assert(results.size() == 1 && stats.index == "id" && stats.candidates == 1);
+
+        assert(parseStudentQuery("faculty=FQ AND dob>=01/02/2001 LIMIT 1 OFFSET 1", query, error));
+        results = repo.query(query);
+        assert(results.size() == 1 && results[0].getId() == "SV152");
+
+        assert(parseStudentQuery("faculty=FQ AND dob=01/02/2001", query, error));
+        results = repo.query(query);
+        assert(results.size() == 1 && results[0].getId() == "SV151");
+
+        assert(parseStudentQuery("faculty=FQ AND dob!=01/02/2001", query, error));
+        results = repo.query(query);
+        assert(results.size() == 2 && results[0].getId() != "SV151" && results[1].getId() != "SV151");
+
+        assert(parseStudentQuery("faculty=NoSuchFaculty", query, error));
+        assert(repo.query(query).empty());
+
+        for (int i = 0; i < 3; ++i) {
+            repo.removeStudent("SV15" + std::to_string(i));
+        }
+        repo.deleteFaculty("FQ");
+
+        std::cout << "testStudentQuery passed.\n";
+    }
+
+    // Test: Kho cột chỉ chứa mã từ điển và thời điểm tạo, cập nhật theo vị trí
+    void testStudentColumns() {
+        StudentColumns columns;
+        Student a("SV161", "Alice", "01/01/2000", "Female", "FL", "2020", "Advanced Program",
+                  "Address 1", "alice@student.university.edu.vn", "+84123456789", "Active");
+        Student b("SV162", "Bob", "02/02/2000", "Male", "FBE", "2021", "Formal Program",
+                  "Address 2", "bob@student.university.edu.vn", "+84987654321", "Graduated");
+        columns.append(a);
+        columns.append(b);
+        assert(columns.size() == 2);
+        assert(columns.status[0] == a.getStatusCode() && columns.faculty[1] == b.getFacultyCode());
+        assert(columns.creationSeconds[1] == std::chrono::system_clock::to_time_t(b.getCreationTime()));
+
+        b.setStatus("Leave");
+        b.setCreationTime(std::chrono::system_clock::from_time_t(1000));
+        columns.assign(1, b);
+        columns.swapRemove(0); // Dòng cuối chuyển vào chỗ trống
+        assert(columns.size() == 1 && columns.status[0] == b.getStatusCode());
+        assert(columns.program[0] == b.getProgramCode() && columns.creationSeconds[0] == 1000);
+
+        std::cout << "testStudentColumns passed.\n";
+    }
+
+    // memory_resource đếm số lần cấp phát, dùng để kiểm tra chuỗi nằm trong arena
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        size_t allocations = 0;
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    // Test: Chuỗi của sinh viên được cấp phát từ arena; bản sao thường không phụ thuộc arena
+    void testStudentArena() {
+        CountingResource arena;
+        Student::allocator_type alloc(&arena);
+        Student s("SV171", "Nguyễn Thị Thanh Hương", "01/01/2000", "Female", "FL", "2020",
+                  "Advanced Program", "227 Nguyen Van Cu, Phuong 4, Quan 5", "huong@student.university.edu.vn",
+                  "+84123456789", "Active", alloc);
+        size_t used = arena.allocations;
+        assert(used >= 3); // Họ tên, địa chỉ, email vượt quá bộ đệm SSO
+
+        // Sao chép thường dùng heap; sao chép kèm allocator dùng arena
+        Student copy = s;
+        assert(arena.allocations == used);
+        Student inArena(copy, alloc);
+        assert(arena.allocations == used * 2);
+        Student moved(std::move(inArena), alloc); // Cùng arena: chỉ chuyển con trỏ
+        assert(arena.allocations == used * 2);
+        assert(moved.getName() == "Nguyễn Thị Thanh Hương" && copy.getEmail() == s.getEmail());
+
+        // Đọc snapshot thẳng vào arena
+        std::vector<Student> students = {s};
+        const std::string filename = "test_arena.bin";
+        assert(writeStudentSnapshot(filename, students));
+        CountingResource loadArena;
+        std::vector<Student> loaded;
+        assert(readStudentSnapshot(filename, loaded, &loadArena));
+        assert(loaded.size() == 1 && loaded[0].getAddress() == s.getAddress());
+        assert(loadArena.allocations == used);
+        std::remove(filename.c_str());
+
+        std::cout << "testStudentArena passed.\n";
+    }
+
+    // Test: Accessor view không sao chép chuỗi; Student chuyển được mà không ném ngoại lệ
+    void testStudentViews() {
+        static_assert(std::is_nothrow_move_constructible<Student>::value,
+                      "vector<Student> phải chuyển phần tử khi cấp phát lại");
+        Student s("SV172", "Trần Thị Bình", "02/02/2001", "Female", "FL", "2021", "Formal Program",
+                  "12 Le Loi, Quan 1", "binh@student.university.edu.vn", "+84987654321", "Active");
+        assert(s.getIdView() == s.getId() && s.getNameView() == s.getName());
+        assert(s.getEmailView() == "binh@student.university.edu.vn" && s.getPhoneView() == "+84987654321");
+        assert(s.getDobView() == "02/02/2001" && s.getCourseView() == "2021" && s.getAddressView() == s.getAddress());
+
+        // View trỏ thẳng vào chuỗi của sinh viên và thấy giá trị mới sau khi sửa
+        s.setEmail(std::string_view("binh2@student.university.edu.vn"));
+        assert(s.getEmailView() == "binh2@student.university.edu.vn");
+
+        // Chỉ mục phụ tra bằng string_view
+        StudentIndex index;
+        index.insert(std::string_view("High Quality Program"), 0);
+        std::string key = "High Quality Program, khóa 2021";
+        assert(index.count(std::string_view(key).substr(0, 20)) == 1);
+        assert(index.count(std::string_view(key)) == 0);
+
+        StudentRepository& repo = StudentRepository::getInstance();
+        assert(repo.findStudent(std::string_view("SV-khong-ton-tai")) == nullptr);
+
+        std::cout << "testStudentViews passed.\n";
+    }
+
+    // Test: Nhật ký ghi nối tiếp, đọc lại đúng thứ tự, bỏ qua bản ghi ghi dở và giữ nguyên
+    // file có bản ghi hỏng ở giữa
+    void testStudentJournal() {
+        std::string filename = "test_students.journal";
+        std::remove(filename.c_str());
+        {
+            StudentJournal journal(filename);
+            assert(journal.open(2));
+            journal.append({{"op", "put"}, {"id", "SV001"}});
+            journal.append({{"op", "put"}, {"id", "SV002"}});
+            journal.append({{"op", "del"}, {"id", "SV001"}});
+            assert(journal.recordCount() == 3);
+        } // Hủy đối tượng sẽ sync phần còn lại
+
+        // Giả lập crash khi đang ghi: dòng cuối không hoàn chỉnh
+        std::ofstream(filename, std::ios::app) << "{\"op\":\"pu";
+
+        StudentJournal journal(filename);
+        std::vector<std::string> ops;
+        size_t applied = journal.replay([&](const json& record) {
+            ops.push_back(record["op"].get<std::string>() + ":" + record["id"].get<std::string>());
+        });
+        assert(applied == 3);
+        assert((ops == std::vector<std::string>{"put:SV001", "put:SV002", "del:SV001"}));
+
+        // Phần ghi dở đã bị cắt: bản ghi mới nối tiếp vẫn đọc được
+        assert(journal.open(1));
+        journal.append({{"op", "put"}, {"id", "SV003"}});
+        ops.clear();
+        assert(journal.replay([&](const json& record) { ops.push_back(record["id"].get<std::string>()); }) == 4);
+        assert(ops.back() == "SV003");
+
+        journal.reset();
+        assert(journal.replay([](const json&) {}) == 0);
+        journal.close();
+
+        // Bản ghi hỏng giữa nhật ký: dừng lại nhưng không cắt file, và không ghi thêm/xóa rỗng
+        const std::string damaged = "{\"op\":\"put\",\"id\":\"SV001\"}\n{\"op\n{\"op\":\"del\",\"id\":\"SV001\"}\n";
+        std::ofstream(filename, std::ios::trunc) << damaged;
+        assert(journal.replay([](const json&) {}) == 1);
+        assert(journal.damaged());
+        assert(journal.open(1));
+        assert(!journal.append({{"op", "put"}, {"id", "SV004"}}));
+        assert(!journal.reset());
+        journal.close();
+        std::ifstream kept(filename);
+        assert(std::string((std::istreambuf_iterator<char>(kept)), std::istreambuf_iterator<char>()) == damaged);
+        kept.close();
+
+        // Sửa file xong thì replay lại bình thường
+        std::ofstream(filename, std::ios::trunc) << "{\"op\":\"put\",\"id\":\"SV001\"}\n";
+        assert(journal.replay([](const json&) {}) == 1);
+        assert(!journal.damaged());
+        std::remove(filename.c_str());
+        std::cout << "testStudentJournal passed.\n";
+    }
+
+    // Test: Chỉ nạp lại students.json khi nội dung thực sự thay đổi
+    void testReloadIfChanged() {
+        StudentRepository& repo = StudentRepository::getInstance();
+        ConfigManager& config = ConfigManager::getInstance();
+        std::string format = config.getStorageFormat();
+        config.setStorageFormat("json");
+        repo.saveStudentDataToFile();
+        assert(repo.reloadIfChanged() == false);
+
+        std::ifstream in("students.json");
+        std::string original((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+
+        // Ghi lại đúng nội dung cũ: không cần nạp lại
+        std::ofstream("students.json") << original;
+        assert(repo.reloadIfChanged() == false);
+
+        // Sửa file từ bên ngoài: dữ liệu mới phải được nạp
+        json j = json::parse(original);
+        Student external("SV201", "External", "01/01/2000", "Male", "FBE", "2020",
+                         "Formal Program", "Address", "ext@student.university.edu.vn",
+                         "+84111111111", "Active");
+        j.push_back(external.toJson());
+        std::ofstream("students.json") << j.dump();
+        assert(repo.reloadIfChanged() == true);
+        assert(repo.findStudent("SV201") != nullptr);
+
+        std::ofstream("students.json") << original;
+        assert(repo.reloadIfChanged() == true);
+        assert(repo.findStudent("SV201") == nullptr);
+
+        config.setStorageFormat(format);
+        repo.saveStudentDataToFile();
+        std::cout << "testReloadIfChanged passed.\n";
+    }
+
+    // Test: Thay đổi trong batch chỉ được ghi khi commit(); rollback() trả về trạng thái đã lưu
+    void testStudentBatch() {
+        StudentRepository& repo = StudentRepository::getInstance();
+        auto readFile = [](const std::string& filename) {
+            std::ifstream in(filename);
+            return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        };
+        auto make = [](const std::string& id, const std::string& faculty) {
+            return Student(id, "Batch " + id, "01/01/2000", "Male", faculty, "2020", "Formal Program", "Address",
+                           "batch@student.university.edu.vn", "+84123456789", "Active");
+        };
+        ConfigManager& config = ConfigManager::getInstance();
+        std::string format = config.getStorageFormat();
+        config.setStorageFormat("json");
+        repo.flush(); // Không để lần ghi nền của test trước rơi vào giữa batch
+        std::string students = readFile("students.json");
+        std::string faculties = readFile("faculties.json");
+
+        repo.beginBatch();
+        repo.addFaculty("FBATCH");
+        repo.addStudent(make("SVB1", "FBATCH")); // Khoa vừa thêm trong batch đã hợp lệ
+        repo.addStudent(make("SVB2", "FBATCH"));
+        repo.addStudent(make("SVB3", "FL"));
+        repo.removeStudent("SVB3");
+        repo.renameFaculty("FBATCH", "FBATCH2");
+        assert(repo.inBatch() && repo.countByFaculty("FBATCH2") == 2);
+        assert(readFile("students.json") == students && readFile("faculties.json") == faculties);
+        assert(repo.reloadIfChanged() == false);
+        assert(repo.commit() && !repo.inBatch());
+        repo.flush();
+        assert(readFile("students.json") != students && readFile("faculties.json") != faculties);
+        repo.loadStudentDataFromFile();
+        assert(repo.findStudent("SVB1") != nullptr && repo.findStudent("SVB3") == nullptr);
+        assert(repo.countByFaculty("FBATCH2") == 2 && repo.isValidFaculty("FBATCH2"));
+
+        // Rollback: bỏ mọi thay đổi trong bộ nhớ, kể cả danh sách khoa. beginBatch() không tự
+        // ghi thay đổi đang chờ ghi nền (SVB6), và rollback() không bỏ thay đổi đó.
+        assert(repo.addStudent(make("SVB6", "FBE")));
+        students = readFile("students.json");
+        size_t count = repo.getStudentCount();
+        repo.beginBatch();
+        assert(readFile("students.json") == students);
+        repo.removeStudent("SVB1"); // Không phải sinh viên cuối: sinh viên cuối được dời chỗ
+        Student edited = *repo.getStudent("SVB2");
+        edited.setAddress("Rolled back");
+        assert(repo.updateStudent("SVB2", edited));
+        assert(repo.addStudent(make("SVB4", "FBE")));
+        repo.addFaculty("FROLLBACK");
+        repo.rollback();
+        assert(!repo.inBatch() && repo.getStudentCount() == count);
+        assert(repo.findStudent("SVB1") != nullptr && repo.findStudent("SVB4") == nullptr);
+        assert(repo.findStudent("SVB6") != nullptr && repo.getStudent("SVB2")->getAddress() == "Address");
+        std::vector<Student> byName = repo.searchByName("Batch SVB1");
+        assert(repo.countByFaculty("FBATCH2") == 2 && byName.size() == 1 && byName[0].getId() == "SVB1");
+        assert(!repo.isValidFaculty("FROLLBACK") && repo.isValidFaculty("FBATCH2"));
+        repo.flush();
+        assert(readFile("students.json") != students); // SVB6 vẫn được ghi
+        assert(repo.removeStudent("SVB6"));
+        repo.flush();
+        students = readFile("students.json");
+
+        // BatchGuard: ngoại lệ trước commit() thì rollback
+        try {
+            StudentRepository::BatchGuard batch(repo);
+            assert(repo.addStudent(make("SVB5", "FBE")));
+            repo.renameFaculty("FBATCH2", "FBATCH3");
+            throw std::runtime_error("abort");
+        } catch (const std::runtime_error&) {
+        }
+        assert(!repo.inBatch() && repo.findStudent("SVB5") == nullptr);
+        assert(repo.isValidFaculty("FBATCH2") && repo.countByFaculty("FBATCH2") == 2);
+
+        // Batch lồng nhau: chỉ commit() ngoài cùng mới ghi
+        repo.beginBatch();
+        repo.beginBatch();
+        repo.removeStudent("SVB1");
+        repo.removeStudent("SVB2");
+        assert(repo.commit() && repo.inBatch());
+        assert(readFile("students.json") == students);
+        assert(repo.commit() && !repo.inBatch());
+        repo.flush();
+        assert(readFile("students.json") != students);
+        assert(repo.commit() == false); // Không có batch đang mở
+        assert(repo.deleteFaculty("FBATCH2"));
+        config.setStorageFormat(format);
+        std::cout << "testStudentBatch passed.\n";
+    }
+
+    // Test: Ghi nền gộp các lần ghi cùng tập dữ liệu; flush/discard đợi ghi xong
+    void testPersistenceScheduler() {
+        std::mutex mutex;
+        std::map<std::string, std::vector<int>> writes;
+        auto writer = [&](const std::string& dataset, int value) {
+            return [&, dataset, value] {
+                std::lock_guard<std::mutex> lock(mutex);
+                writes[dataset].push_back(value);
+            };
+        };
+        {
+            PersistenceScheduler scheduler(std::chrono::milliseconds(200));
+            for (int i = 1; i <= 100; ++i) {
+                scheduler.schedule("a", writer("a", i));
+            }
+            scheduler.schedule("b", writer("b", 1));
+            assert(scheduler.isPending("a") && scheduler.writesCompleted() == 0); // Chưa đến hạn
+            scheduler.flush();
+            assert(!scheduler.isPending("a") && !scheduler.isPending("b"));
+            assert((writes["a"] == std::vector<int>{100}) && writes["b"].size() == 1); // Chỉ ghi bản mới nhất
+
+            // Hết hạn thì tự ghi, không cần flush
+            scheduler.setInterval(std::chrono::milliseconds(10));
+            scheduler.schedule("a", writer("a", 101));
+            for (int i = 0; i < 500 && scheduler.isPending("a"); ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            assert(!scheduler.isPending("a") && writes["a"].back() == 101);
+
+            // discard bỏ lần ghi đang chờ
+            scheduler.setInterval(std::chrono::milliseconds(1000));
+            scheduler.schedule("b", writer("b", 2));
+            scheduler.discard("b");
+            scheduler.schedule("c", writer("c", 1));
+        } // Destructor ghi nốt "c"
+        assert(writes["b"].size() == 1 && writes["c"].size() == 1);
+
+        // Repository: lệnh trả về trước khi ghi; flush() đưa thay đổi xuống file
+        StudentRepository& repo = StudentRepository::getInstance();
+        repo.flush();
+        repo.addStatus("Exchange");
+        repo.flush();
+        std::ifstream in("statuses.json");
+        assert(json::parse(in).dump().find("Exchange") != std::string::npos);
+        in.close();
+        assert(repo.deleteStatus("Exchange"));
+        repo.flush();
+        std::cout << "testPersistenceScheduler passed.\n";
+    }
+
+    // Test: Nhiều luồng đọc song song với một luồng ghi; luồng đọc không thấy batch dở dang
+    void testConcurrentRepository() {
+        RepositoryLock lock;
+        {
+            RepositoryLock::WriteGuard write(lock);
+            RepositoryLock::ReadGuard read(lock);  // Luồng đang ghi được đọc lại
+            RepositoryLock::WriteGuard again(lock); // và ghi lồng nhau
+            assert(lock.ownedByCurrentThread());
+        }
+        {
+            RepositoryLock::ReadGuard read(lock);
+            RepositoryLock::ReadGuard nested(lock);
+            bool threw = false;
+            try {
+                RepositoryLock::WriteGuard upgrade(lock);
+            } catch (const std::logic_error&) {
+                threw = true;
+            }
+            assert(threw && !lock.ownedByCurrentThread());
+        }
+
+        StudentRepository& repo = StudentRepository::getInstance();
+        auto make = [](const std::string& id, const std::string& name) {
+            return Student(id, name, "01/01/2000", "Male", "FCONC", "2020", "Formal Program", "Address",
+                           "concurrent@student.university.edu.vn", "+84123456789", "Active");
+        };
+        const int kStudents = 50;
+        size_t before = repo.getStudentCount();
+        repo.beginBatch();
+        repo.addFaculty("FCONC");
+        for (int i = 0; i < kStudents; ++i) {
+            repo.addStudent(make("SVC" + std::to_string(i), "Concurrent " + std::to_string(i)));
+        }
+        repo.commit();
+
+        std::atomic<bool> done{false};
+        std::atomic<int> failures{0};
+        std::atomic<long> reads{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&, t] {
+                int round = 0;
+                while (!done.load()) {
+                    std::string id = "SVC" + std::to_string(round % kStudents);
+                    std::optional<Student> student = repo.getStudent(id);
+                    // Batch của luồng ghi xóa rồi thêm lại SVC0..: luồng đọc chỉ thấy trước hoặc sau batch
+                    if (!student || student->getIdView() != id || student->getFaculty() != "FCONC") {
+                        ++failures;
+                    }
+                    if (repo.searchByName("Concurrent", NameMatchMode::Prefix).size() < static_cast<size_t>(kStudents) ||
+                        repo.countByFaculty("FCONC") < static_cast<size_t>(kStudents)) {
+                        ++failures;
+                    }
+                    {
+                        auto view = repo.readLock();
+                        const Student* pointer = repo.findStudent(id);
+                        if (pointer == nullptr || pointer->getIdView() != id) {
+                            ++failures;
+                        }
+                    }
+                    // Tạo sinh viên ngoài repository thêm giá trị mới vào từ điển dùng chung
+                    Student local("L" + id, "Local", "01/01/2000", "Male", "FLOCAL" + std::to_string(t * 1000 + round % 200),
+                                  "2020", "Formal Program", "Address", "local@student.university.edu.vn",
+                                  "+84123456789", "Active");
+                    if (local.getFaculty() != "FLOCAL" + std::to_string(t * 1000 + round % 200)) {
+                        ++failures;
+                    }
+                    ++round;
+                    ++reads;
+                }
+            });
+        }
+        for (int round = 0; round < 100; ++round) {
+            std::string id = "SVC" + std::to_string(round % kStudents);
+            repo.beginBatch();
+            std::optional<Student> current = repo.getStudent(id);
+            assert(current);
+            repo.removeStudent(id);
+            repo.addStudent(*current);
+            repo.addStudent(make("SVCX" + std::to_string(round), "Extra"));
+            repo.commit();
+            repo.removeStudent("SVCX" + std::to_string(round));
+        }
+        done = true;
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        assert(failures.load() == 0 && reads.load() > 0);
+
+        repo.beginBatch();
+        for (int i = 0; i < kStudents; ++i) {
+            repo.removeStudent("SVC" + std::to_string(i));
+        }
+        repo.commit();
+        assert(repo.getStudentCount() == before && repo.deleteFaculty("FCONC"));
+        repo.flush();
+        std::cout << "testConcurrentRepository passed.\n";
+    }
+
+    // Test: Logger bất đồng bộ không làm mất dòng khi nhiều luồng ghi vượt sức chứa hàng đợi
+    void testAsyncLogger() {
+        auto countLines = [] {
+            std::ifstream in("student_management.log");
+            size_t lines = 0;
+            std::string line;
+            while (std::getline(in, line)) ++lines;
+            return lines;
+        };
+        Logger& logger = Logger::getInstance();
+        logger.flush();
+        size_t before = countLines();
+
+        const int threads = 4, perThread = 2000;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&logger, t] {
+                for (int i = 0; i < perThread; ++i) {
+                    logger.log("testAsyncLogger " + std::to_string(t) + ":" + std::to_string(i));
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        logger.flush();
+        assert(countLines() == before + threads * perThread);
+
+        // Dòng lỗi có mặt trong file ngay khi log() trả về
+        logger.log("testAsyncLogger error", LogLevel::Error);
+        assert(countLines() == before + threads * perThread + 1);
+        std::cout << "testAsyncLogger passed.\n";
+    }
+
+    // Test: Ghi/đọc snapshot nhị phân và chuyển đổi qua lại với JSON
+    void testStudentSnapshot() {
+        std::string binFile = "test_students.bin", jsonFile = "test_students.json";
+        std::vector<Student> students = {
+            Student("SV001", "Nguyễn Văn A", "01/01/2000", "Male", "FBE", "2020", "Formal Program",
+                    "227 Nguyễn Văn Cừ, Q5", "a@student.university.edu.vn", "+84123", "Active"),
+            Student("SV002", "Trần Thị B", "02/02/2001", "Female", "FBE", "2021", "Formal Program",
+                    "", "b@student.university.edu.vn", "+84456", "Graduated")
+        };
+        students[0].setCreationTime(iso8601ToTimePoint("2023-04-01T10:00:00Z"));
+
+        assert(writeStudentSnapshot(binFile, students));
+        std::vector<Student> loaded;
+        assert(readStudentSnapshot(binFile, loaded));
+        assert(loaded.size() == students.size());
+        for (size_t i = 0; i < students.size(); ++i) {
+            assert(loaded[i].toJson() == students[i].toJson());
+        }
+
+        // JSON -> nhị phân -> JSON giữ nguyên dữ liệu
+        assert(convertSnapshotToJson(binFile, jsonFile));
+        assert(convertJsonToSnapshot(jsonFile, binFile));
+        loaded.clear();
+        assert(readStudentSnapshot(binFile, loaded));
+        assert(loaded[1].toJson() == students[1].toJson());
+
+        // File bị cắt cụt bị từ chối và không làm thay đổi dữ liệu đầu ra
+        std::ifstream in(binFile, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream(binFile, std::ios::binary) << bytes.substr(0, bytes.size() - 3);
+        assert(!readStudentSnapshot(binFile, loaded));
+        assert(loaded.size() == 2);
+
+        // Hỏng một byte mà cấu trúc vẫn hợp lệ: checksum ở footer phát hiện được
+        std::string corrupt = bytes;
+        corrupt[corrupt.find("Nguy")] = 'n';
+        std::ofstream(binFile, std::ios::binary) << corrupt;
+        assert(!readStudentSnapshot(binFile, loaded));
+
+        // File phiên bản 1 (không có footer) vẫn đọc được
+        std::string version1 = bytes.substr(0, bytes.size() - 12);
+        version1[4] = 1;
+        std::ofstream(binFile, std::ios::binary) << version1;
+        loaded.clear();
+        assert(readStudentSnapshot(binFile, loaded) && loaded.size() == 2);
+
+        // Số bản ghi hoặc kích thước bảng chuỗi quá lớn bị từ chối trước khi cấp phát
+        std::string hugeCount = version1;
+        hugeCount.replace(8, 8, std::string(8, '\xff'));
+        std::ofstream(binFile, std::ios::binary) << hugeCount;
+        assert(!readStudentSnapshot(binFile, loaded) && loaded.size() == 2);
+        std::string hugeTable = version1;
+        hugeTable.replace(24, 4, std::string(4, '\xff'));
+        std::ofstream(binFile, std::ios::binary) << hugeTable;
+        assert(!readStudentSnapshot(binFile, loaded) && loaded.size() == 2);
+
+        std::remove(binFile.c_str());
+        std::remove(jsonFile.c_str());
+        std::remove(digestFilename(jsonFile).c_str());
+        std::cout << "testStudentSnapshot passed.\n";
+    }
+
+    // Test: Ghi đè file qua file tạm + rename; lỗi không làm hỏng file đích
+    void testAtomicFile() {
+        std::string filename = "test_atomic.json";
+        assert(writeFileAtomic(filename, "[1, 2]\n"));
+        assert(writeFileAtomic(filename, {"[3, ", "4]\n"}));
+        std::ifstream in(filename);
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        assert(content == "[3, 4]\n");
+        assert(!std::ifstream(filename + ".tmp").is_open()); // Không để lại file tạm
+
+        // Thư mục không tồn tại: trả về false
+        assert(!writeFileAtomic("khong-co-thu-muc/" + filename, "x"));
+
+        // Không đổi tên được (đích là thư mục): file tạm bị xóa
+        std::string directory = "test_atomic_dir";
+        ::mkdir(directory.c_str(), 0755);
+        ::mkdir((directory + "/sub").c_str(), 0755);
+        assert(!writeFileAtomic(directory + "/sub", "x"));
+        assert(!std::ifstream(directory + "/sub.tmp").is_open());
+        std::remove((directory + "/sub").c_str()); // remove() cũng xóa được thư mục rỗng
+        std::remove(directory.c_str());
+
+        // File tóm tắt: khớp sau khi ghi, không khớp khi nội dung bị sửa hoặc thiếu tóm tắt
+        assert(writeFileAtomicWithDigest(filename, {"[5, ", "6]\n"}));
+        assert(verifyFileDigest(filename));
+        std::ofstream(filename) << "[5, 7]\n";
+        assert(!verifyFileDigest(filename));
+        assert(writeFileAtomicWithDigest(filename, "[8]\n"));
+        assert(verifyFileDigest(filename));
+        std::remove(digestFilename(filename).c_str());
+        assert(!verifyFileDigest(filename));
+
+        std::remove(filename.c_str());
+        std::cout << "testAtomicFile passed.\n";
+    }
+
+    // Test: Đọc students.json theo kiểu SAX
+    void testStudentJsonReader() {
+        std::string jsonFile = "test_students_sax.json";
+        std::ofstream(jsonFile) << R"([
+            {"id": "SV101", "name": "Nguyễn Văn A", "dob": "01/01/2000", "gender": "Male",
+             "faculty": "FL", "course": 2020, "program": "Formal Program", "address": "Q5",
+             "email": "a@student.university.edu.vn", "phone": "+84123", "status": "Active",
+             "creationTime": "2023-04-01T10:00:00Z", "notes": {"tags": ["x", 1], "phone": "+84999"}},
+            {"id": "SV102", "name": "Trần Thị B", "faculty": "FBE", "status": "Graduated"}
+        ])";
+        std::vector<Student> loaded;
+        size_t lastBytes = 0, lastCount = 0;
+        assert(readStudentJson(jsonFile, [&](Student&& s) { loaded.push_back(std::move(s)); },
+                               [&](size_t bytesRead, size_t, size_t count) { lastBytes = bytesRead; lastCount = count; }));
+        assert(loaded.size() == 2 && lastCount == 2 && lastBytes > 0);
+        assert(loaded[0].getName() == "Nguyễn Văn A" && loaded[0].getCourse() == "2020");
+        assert(loaded[0].getPhone() == "+84123"); // Khóa lồng trong "notes" bị bỏ qua
+        assert(timePointToISO8601(loaded[0].getCreationTime()) == "2023-04-01T10:00:00Z");
+        assert(loaded[1].getStatus() == "Graduated" && loaded[1].getEmail().empty());
+
+        // JSON Lines (kiểu "lines" của dumpJson) và file rỗng
+        std::ofstream(jsonFile) << "{\"id\": \"SV103\", \"course\": 2022}\n\n{\"id\": \"SV104\"}\n";
+        loaded.clear();
+        assert(readStudentJson(jsonFile, [&](Student&& s) { loaded.push_back(std::move(s)); }));
+        assert(loaded.size() == 2 && loaded[0].getCourse() == "2022" && loaded[1].getId() == "SV104");
+        std::ofstream(jsonFile) << "  \n";
+        loaded.clear();
+        assert(readStudentJson(jsonFile, [&](Student&& s) { loaded.push_back(std::move(s)); }) && loaded.empty());
+
+        // `verified`: chỉ đúng khi nội dung khớp file tóm tắt
+        const std::string saved = "[{\"id\": \"SV105\"}]\n";
+        bool verified = false;
+        assert(writeFileAtomicWithDigest(jsonFile, saved));
+        assert(readStudentJson(jsonFile, [](Student&&) {}, nullptr, std::pmr::get_default_resource(), nullptr,
+                               &verified) && verified);
+        std::ofstream(jsonFile) << "[{\"id\": \"SV106\"}]\n";
+        assert(readStudentJson(jsonFile, [](Student&&) {}, nullptr, std::pmr::get_default_resource(), nullptr,
+                               &verified) && !verified);
+        std::remove(digestFilename(jsonFile).c_str());
+
+        // Sai cú pháp, gốc không phải mảng/đối tượng, hoặc thiếu MSSV đều bị từ chối kèm mô tả lỗi
+        const char* invalid[] = {R"([{"id": "SV1"}, {"id": )", R"("SV1")", R"([{"name": "A"}])", R"([1])",
+                                 "{\"id\": \"SV1\"}\n[]\n"};
+        for (const char* content : invalid) {
+            std::ofstream(jsonFile) << content;
+            std::string error;
+            assert(!readStudentJson(jsonFile, [](Student&&) {}, nullptr, std::pmr::get_default_resource(), &error));
+            assert(!error.empty());
+        }
+
+        std::remove(jsonFile.c_str());
+        std::cout << "testStudentJsonReader passed.\n";
+    }
+
     // Test: Xuất và nhập file CSV
     void testRecordIO_CSV() {
         RecordIO recordIO;
@@ -82,6 +972,62 @@ namespace Test {
         std::cout << "testRecordIO_CSV passed.\n";
     }
 
+    // Test: CSV có dấu phẩy, dấu nháy, xuống dòng trong trường; dữ liệu cắt ở vị trí bất kỳ
+    void testCsvQuoting() {
+        RecordIO recordIO;
+        std::string filename = "test_quoting.csv";
+        std::vector<std::vector<std::string>> records = {
+            {"SV001", "Alice", "227 Nguyen Van Cu, Q5, HCM", "say \"hi\"", ""},
+            {"SV002", "Bob", "line1\nline2", "a\r\nb", ","}
+        };
+        assert(recordIO.exportToCSV(filename, records));
+        assert(recordIO.importFromCSV(filename) == records);
+        std::remove(filename.c_str());
+
+        std::string text = "a,\"b,1\",c\r\n\r\n\"x\"\"y\",,\n\"multi\nline\",z";
+        std::vector<std::vector<std::string>> expected = {
+            {"a", "b,1", "c"}, {"x\"y", "", ""}, {"multi\nline", "z"}
+        };
+        // Nạp từng byte một để kiểm tra trạng thái qua ranh giới các khối dữ liệu
+        std::vector<std::vector<std::string>> parsed;
+        CsvParser parser([&](const std::vector<std::string>& record) { parsed.push_back(record); });
+        for (char c : text) parser.feed(&c, 1);
+        parser.finish();
+        assert(parsed == expected);
+
+        parsed.clear();
+        CsvParser whole([&](const std::vector<std::string>& record) { parsed.push_back(record); });
+        whole.feed(text.data(), text.size());
+        whole.finish();
+        assert(parsed == expected);
+        std::cout << "testCsvQuoting passed.\n";
+    }
+
+    // Test: Các bản SIMD của bộ quét CSV cho kết quả giống bản vô hướng ở mọi vị trí
+    void testCsvScanner() {
+        std::string text;
+        for (int i = 0; i < 300; ++i) {
+            text += (i % 37 == 0) ? ',' : (i % 53 == 0) ? '"' : (i % 71 == 0) ? '\n' : static_cast<char>('a' + i % 26);
+        }
+        CsvScanMode original = getCsvScanMode();
+        std::vector<const char*> expectedDelim, expectedQuote;
+        setCsvScanMode(CsvScanMode::Scalar);
+        const char* end = text.data() + text.size();
+        for (size_t i = 0; i <= text.size(); ++i) {
+            expectedDelim.push_back(csvFindFieldDelimiter(text.data() + i, end));
+            expectedQuote.push_back(csvFindQuote(text.data() + i, end));
+        }
+        for (CsvScanMode mode : {CsvScanMode::SSE2, CsvScanMode::AVX2}) {
+            if (!setCsvScanMode(mode)) continue;
+            for (size_t i = 0; i <= text.size(); ++i) {
+                assert(csvFindFieldDelimiter(text.data() + i, end) == expectedDelim[i]);
+                assert(csvFindQuote(text.data() + i, end) == expectedQuote[i]);
+            }
+        }
+        setCsvScanMode(original);
+        std::cout << "testCsvScanner passed (" << csvScanModeName(original) << ").\n";
+    }
+
     // Test: Xuất và nhập file JSON
     void testRecordIO_JSON() {
         RecordIO recordIO;
@@ -102,6 +1048,192 @@ namespace Test {
         std::cout << "testRecordIO_JSON passed.\n";
     }
 
+    // Test: Ba kiểu ghi JSON và khả năng đọc lại của các loader
+    void testJsonOutputStyle() {
+        json students = json::array({
+            Student("SV201", "Lê Văn C", "03/03/2002", "Male", "FL", "2022", "Formal Program", "", "c@x", "+84", "Active").toJson(),
+            Student("SV202", "Phạm Thị D", "04/04/2003", "Female", "FL", "2023", "Formal Program", "", "d@x", "+84", "Active").toJson()
+        });
+        std::string compact = dumpJson(students, JsonOutputStyle::Compact);
+        assert(compact.find('\n') == compact.size() - 1);
+        std::string lines = dumpJson(students, JsonOutputStyle::Lines);
+        assert(std::count(lines.begin(), lines.end(), '\n') == 2 && lines.front() == '{');
+        assert(dumpJson(json{{"a", 1}}, JsonOutputStyle::Lines) == "{\"a\":1}\n"); // Đối tượng: như Compact
+
+        const JsonOutputStyle styles[] = {JsonOutputStyle::Pretty, JsonOutputStyle::Compact, JsonOutputStyle::Lines};
+        std::string filename = "test_style.json";
+        for (JsonOutputStyle style : styles) {
+            JsonOutputStyle parsed;
+            assert(parseJsonOutputStyle(jsonOutputStyleName(style), parsed) && parsed == style);
+
+            // Danh sách dạng mảng (khoa/chương trình/tình trạng), kể cả một phần tử hoặc rỗng
+            for (const json& list : {json{"FL", "FBE"}, json{"FL"}, json::array()}) {
+                std::istringstream in(dumpJson(list, style));
+                assert(parseJsonRecords(in) == list);
+            }
+
+            // students.json qua bộ đọc SAX
+            std::ofstream(filename) << dumpJson(students, style);
+            std::vector<Student> loaded;
+            assert(readStudentJson(filename, [&](Student&& st) { loaded.push_back(std::move(st)); }));
+            assert(loaded.size() == 2 && loaded[1].toJson() == students[1]);
+
+            // Xuất/nhập JSON của RecordIO, kể cả file chỉ có một bản ghi
+            RecordIO recordIO;
+            std::vector<std::vector<std::string>> records = {{"SV201", "Lê Văn C"}, {"SV202", "Phạm Thị D"}};
+            assert(recordIO.exportToJSON(filename, records, style));
+            assert(recordIO.importFromJSON(filename) == records);
+            records.pop_back();
+            assert(recordIO.exportToJSON(filename, records, style));
+            assert(recordIO.importFromJSON(filename) == records);
+        }
+        JsonOutputStyle unchanged = JsonOutputStyle::Compact;
+        assert(!parseJsonOutputStyle("indented", unchanged) && unchanged == JsonOutputStyle::Compact);
+
+        std::remove(filename.c_str());
+        std::cout << "testJsonOutputStyle passed.\n";
+    }
+
+    // Test: NDJSON ghi/đọc theo luồng và chia file thành các khoảng byte
+    void testRecordIO_NDJSON() {
+        RecordIO recordIO;
+        std::string filename = "test_export.ndjson";
+        NDJSONWriter writer;
+        assert(writer.open(filename));
+        for (int i = 0; i < 100; ++i) {
+            writer.write({{"id", "SV" + std::to_string(i)}, {"name", "Nguyễn Văn " + std::to_string(i)}});
+        }
+        assert(writer.close() && writer.count() == 100);
+
+        std::vector<std::string> ids;
+        assert(recordIO.importFromNDJSON(filename, [&](const json& record) { ids.push_back(record["id"]); }));
+        assert(ids.size() == 100 && ids[0] == "SV0" && ids[99] == "SV99");
+
+        // Mỗi dòng thuộc đúng một khoảng, dù chia theo splitNDJSON hay tại vị trí bất kỳ
+        for (size_t parts : {1, 3, 7, 1000}) {
+            auto ranges = recordIO.splitNDJSON(filename, parts);
+            assert(!ranges.empty() && ranges.size() <= parts && ranges.front().first == 0);
+            std::vector<std::string> joined;
+            for (const auto& range : ranges) {
+                recordIO.importFromNDJSON(filename, [&](const json& record) { joined.push_back(record["id"]); },
+                                          range.first, range.second);
+            }
+            assert(joined == ids);
+        }
+        const size_t cuts[] = {0, 17, 1234, SIZE_MAX};
+        std::vector<std::string> joined;
+        for (size_t i = 0; i + 1 < sizeof(cuts) / sizeof(cuts[0]); ++i) {
+            recordIO.importFromNDJSON(filename, [&](const json& record) { joined.push_back(record["id"]); },
+                                      cuts[i], cuts[i + 1]);
+        }
+        assert(joined == ids);
+
+        // Dòng trống, CRLF và dòng hỏng
+        std::ofstream(filename) << "{\"id\":\"A\"}\r\n\n{\"id\":\n{\"id\":\"B\"}";
+        ids.clear();
+        assert(recordIO.importFromNDJSON(filename, [&](const json& record) { ids.push_back(record["id"]); }));
+        assert((ids == std::vector<std::string>{"A", "B"}));
+
+        // Nhập vào repository: số được đọc như chuỗi và creationTime được giữ, như khi nạp
+        // students.json. Batch ngoài cùng được rollback để không đổi dữ liệu.
+        StudentRepository& repo = StudentRepository::getInstance();
+        ConfigManager::getInstance().setEmailSuffix("@student.university.edu.vn");
+        ConfigManager::getInstance().setPhoneRegex("+84");
+        std::ofstream(filename) << R"({"id": 22127901, "name": "NDJSON A", "dob": "01/01/2000", "gender": "Male",)"
+                                << R"( "faculty": "FBE", "course": 2021, "program": "Formal Program", "address": "Q5",)"
+                                << R"( "email": "a@student.university.edu.vn", "phone": "+84123456789",)"
+                                << R"( "status": "Active", "creationTime": "2023-04-01T10:00:00Z", "notes": [1]})"
+                                << "\n";
+        repo.beginBatch();
+        assert(repo.importStudentsFromNDJSON(filename));
+        std::optional<Student> imported = repo.getStudent("22127901");
+        assert(imported && imported->getCourse() == "2021");
+        assert(timePointToISO8601(imported->getCreationTime()) == "2023-04-01T10:00:00Z");
+        repo.rollback();
+        assert(!repo.getStudent("22127901"));
+
+        std::remove(filename.c_str());
+        std::cout << "testRecordIO_NDJSON passed.\n";
+    }
+
+    // Test: Nhập hàng loạt song song giữ thứ tự đầu vào, báo lỗi theo số dòng, MSSV trùng lấy bản đầu
+    void testParallelImport() {
+        ThreadPool pool(4);
+        std::vector<std::future<int>> squares;
+        for (int i = 0; i < 100; ++i) {
+            squares.push_back(pool.submit([i] { return i * i; }));
+        }
+        for (int i = 0; i < 100; ++i) {
+            assert(squares[i].get() == i * i);
+        }
+
+        ConfigManager& config = ConfigManager::getInstance();
+        bool enforce = config.getEnforceValidation();
+        config.setEnforceValidation(true);
+        config.setEmailSuffix("@student.university.edu.vn");
+        config.setPhoneRegex("+84");
+        StudentRepository& repo = StudentRepository::getInstance();
+        clearStudentRepository();
+        const size_t before = repo.getAllStudentsAsStrings().size(); // Sinh viên không xóa được
+
+        const size_t count = 5000; // Nhiều lô
+        std::vector<std::vector<std::string>> records;
+        for (size_t i = 0; i < count; ++i) {
+            std::string id = "PI" + std::to_string(i);
+            records.push_back({id, "Sinh viên " + std::to_string(i), "01/01/2000", "Male", "Faculty of Law",
+                               "2020", "Formal Program", "Address", id + "@student.university.edu.vn",
+                               "+84123456789", "Active"});
+        }
+        records[3][8] = "sai@gmail.com";          // Bản ghi 4: email sai
+        records[2500].pop_back();                  // Bản ghi 2501: thiếu trường
+        records[4999] = records[7];                // Bản ghi 5000: trùng MSSV với bản ghi 8
+        records[4999][1] = "Bản sao";
+
+        std::ostringstream output;
+        std::streambuf* original = std::cout.rdbuf(output.rdbuf());
+        size_t skipped = repo.importStudentRecords([&](const StudentRepository::RecordSink& sink) {
+            for (const auto& record : records) {
+                sink(record);
+            }
+        });
+        std::cout.rdbuf(original);
+
+        assert(skipped == 3);
+        std::string log = output.str();
+        size_t email = log.find("Bản ghi 4 (PI3): Email không hợp lệ.");
+        size_t fields = log.find("Bản ghi 2501 (PI2500): Dữ liệu không hợp lệ.");
+        size_t duplicate = log.find("Bản ghi 5000: MSSV đã tồn tại");
+        assert(email != std::string::npos && fields != std::string::npos && duplicate != std::string::npos);
+        assert(email < fields && fields < duplicate);
+
+        // Thứ tự trong danh sách đúng thứ tự đầu vào
+        auto students = repo.getAllStudentsAsStrings();
+        assert(students.size() == before + count - 3);
+        assert(students[before][0] == "PI0" && students[before + 3][0] == "PI4" && students.back()[0] == "PI4998");
+        assert(repo.findStudent(std::string_view("PI7"))->getName() == "Sinh viên 7");
+        assert(repo.findStudent(std::string_view("PI3")) == nullptr);
+
+        // importStudentRecords không lưu file: nạp lại để bỏ các bản ghi vừa nhập
+        repo.loadStudentDataFromFile();
+        assert(repo.getAllStudentsAsStrings().size() == before);
+
+        // Nguồn ném ngoại lệ: các bản ghi đã đọc vẫn được thêm, ngoại lệ được ném lại cho người gọi
+        bool thrown = false;
+        try {
+            repo.importStudentRecords([&](const StudentRepository::RecordSink& sink) {
+                sink(records[0]);
+                throw std::runtime_error("lỗi đọc");
+            });
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && repo.isStudentIdExists("PI0"));
+
+        repo.loadStudentDataFromFile();
+        config.setEnforceValidation(enforce);
+        std::cout << "testParallelImport passed.\n";
+    }
+
     // Test: Cấu hình email và phone thông qua ConfigManager
     void testConfigManager() {
         ConfigManager& config = ConfigManager::getInstance();
@@ -165,8 +1297,165 @@ namespace Test {
 
         std::cout << "testConcreteStudentValidator passed.\n";
     }
-}
 
-#endif // UNIT_TEST_HPP_
+    // Test: Validator tự cập nhật khi cấu hình đổi; kiểm tra định dạng Khóa và Ngày sinh
+    void testValidatorConfigRefresh() {
+        ConfigManager& config = ConfigManager::getInstance();
+        StudentRepository& repo = StudentRepository::getInstance();
+        ConcreteStudentValidator validator(&repo);
+        auto make = [](const std::string& phone, const std::string& course, const std::string& dob) {
+            return Student("SV001", "Alice", dob, "Female", "Faculty of Law", course,
+                           "Advanced Program", "Address 1", "alice@student.university.edu.vn",
+                           phone, "Active");
+        };
+        bool enforce = config.getEnforceValidation();
+        config.setEnforceValidation(true);
+        config.setEmailSuffix("@student.university.edu.vn");
+
+        config.setPhoneRegex("+84");
+        assert(validator.isValid(make("+84912345678", "2020", "01/01/2000")));
+        assert(!validator.isValid(make("0912345678", "2020", "01/01/2000")));
+
+        // Đổi sang regex: validator phải dùng mẫu mới mà không cần tạo lại
+        config.setPhoneRegex("^0[35789][0-9]{8}$");
+        assert(validator.isValid(make("0912345678", "2020", "01/01/2000")));
+        assert(!validator.isValid(make("+84912345678", "2020", "01/01/2000")));
+
+        config.setPhoneRegex("+84");
+        assert(!validator.isValid(make("+84912345678", "202", "01/01/2000")));
+        assert(!validator.isValid(make("+84912345678", "20a0", "01/01/2000")));
+        assert(!validator.isValid(make("+84912345678", "2020", "1/01/2000")));
+        assert(!validator.isValid(make("+84912345678", "2020", "01-01-2000")));
+        assert(!validator.isValid(make("+84912345678", "2020", "01/01/2000 ")));
+
+        // Danh sách khoa đổi: validator phải chụp lại danh sách mà không cần tạo lại
+        Student student = make("+84912345678", "2020", "01/01/2000");
+        student.setFaculty("FVALIDATOR");
+        assert(!validator.isValid(student));
+        repo.addFaculty("FVALIDATOR");
+        assert(validator.isValid(student));
+        repo.deleteFaculty("FVALIDATOR");
+        assert(!validator.isValid(student));
+
+        config.setEnforceValidation(enforce);
+        std::cout << "testValidatorConfigRefresh passed.\n";
+    }
+
+    // Test: Các endpoint JSON của chế độ máy chủ, gọi trực tiếp không qua socket
+    void testStudentApi() {
+        StudentRepository& repo = StudentRepository::getInstance();
+        ConfigManager& config = ConfigManager::getInstance();
+        config.setEmailSuffix("@student.university.edu.vn");
+        config.setPhoneRegex("+84");
+        repo.addFaculty("FAPI");
+        auto call = [&repo](const std::string& method, const std::string& path,
+                            const std::map<std::string, std::string>& query = {}, const std::string& body = "") {
+            HttpRequest request;
+            request.method = method;
+            request.path = path;
+            request.query = query;
+            request.body = body;
+            return handleStudentApiRequest(repo, request);
+        };
+        json student = {{"id", "SVAPI1"}, {"name", "Trần Api"}, {"dob", "01/01/2000"}, {"gender", "Male"},
+                        {"faculty", "FAPI"}, {"course", "2020"}, {"program", "Formal Program"},
+                        {"address", "Address"}, {"email", "api@student.university.edu.vn"},
+                        {"phone", "+84123456789"}, {"status", "Active"}};
+
+        assert(call("POST", "/students", {}, student.dump()).status == 201);
+        assert(call("POST", "/students", {}, student.dump()).status == 409);
+        assert(call("POST", "/students", {}, "{\"id\": 1}").status == 400);
+        assert(call("POST", "/students", {}, "not json").status == 400);
+        json invalid = student;
+        invalid["id"] = "SVAPI2";
+        invalid["email"] = "api@gmail.com";
+        assert(call("POST", "/students", {}, invalid.dump()).status == 422);
+
+        HttpResponse found = call("GET", "/students/SVAPI1");
+        assert(found.status == 200 && json::parse(found.body)["name"] == "Trần Api");
+        assert(call("GET", "/students/SVAPI2").status == 404);
+        json byName = json::parse(call("GET", "/students", {{"name", "tran api"}, {"mode", "prefix"}}).body);
+        assert(byName["count"] == 1 && byName["students"][0]["id"] == "SVAPI1");
+        json byFaculty = json::parse(call("GET", "/students", {{"faculty", "FAPI"}}).body);
+        assert(byFaculty["count"] == 1);
+        assert(json::parse(call("GET", "/students", {{"limit", "1"}}).body)["count"] == 1);
+        assert(call("GET", "/students", {{"limit", "-1"}}).status == 400);
+        json queried = json::parse(call("GET", "/query", {{"q", "faculty=FAPI AND status=Active"}}).body);
+        assert(queried["count"] == 1 && queried["index"] != "scan");
+        assert(call("GET", "/query", {{"q", "faculty=="}}).status == 400);
+
+        // Sửa một phần; chuyển tình trạng theo quy luật
+        HttpResponse updated = call("PUT", "/students/SVAPI1", {}, R"({"address": "New Address"})");
+        assert(updated.status == 200 && json::parse(updated.body)["address"] == "New Address");
+        assert(repo.getStudent("SVAPI1")->getName() == "Trần Api");
+        assert(call("PUT", "/students/SVAPI1", {}, R"({"status": "Graduated"})").status == 200);
+        assert(call("PUT", "/students/SVAPI1", {}, R"({"status": "Active"})").status == 422);
+        assert(call("PUT", "/students/SVAPI1", {}, R"({"email": "x@gmail.com"})").status == 422);
+        assert(call("PUT", "/students/NOPE", {}, "{}").status == 404);
+
+        HttpResponse cert = call("GET", "/students/SVAPI1/certificate", {{"purpose", "Kiểm tra"}});
+        assert(cert.status == 200 && cert.contentType.find("markdown") != std::string::npos);
+        assert(cert.body.find("Trần Api") != std::string::npos && cert.body.find("Kiểm tra") != std::string::npos);
+        assert(call("GET", "/students/SVAPI1/certificate", {{"format", "pdf"}}).status == 400);
+
+        assert(call("PATCH", "/students/SVAPI1").status == 405);
+        assert(call("GET", "/unknown").status == 404);
+        assert(call("DELETE", "/students/SVAPI1").status == 204);
+        assert(call("DELETE", "/students/SVAPI1").status == 404);
+        assert(!repo.inBatch());
+        repo.deleteFaculty("FAPI");
+        std::cout << "testStudentApi passed.\n";
+    }
 
+    // Test: Máy chủ HTTP trên socket thật: hai yêu cầu gửi liền trên một kết nối keep-alive
+    void testHttpServer() {
+        HttpServer server([](const HttpRequest& request) {
+            if (request.path == "/fail") {
+                throw std::runtime_error("handler failed");
+            }
+            HttpResponse response;
+            response.body = json({{"path", request.path}, {"body", request.body},
+                                  {"q", request.query.count("q") ? request.query.at("q") : ""}}).dump();
+            return response;
+        }, 2);
+        assert(server.listen("127.0.0.1", 0) && server.port() != 0);
+        std::thread loop([&server] { server.run(); });
 
+        // Gửi `request` rồi đọc đến khi máy chủ đóng kết nối
+        auto exchange = [&server](const std::string& request) {
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(server.port());
+            inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+            assert(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+            assert(send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+            std::string reply;
+            char buffer[4096];
+            ssize_t n;
+            while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+                reply.append(buffer, static_cast<size_t>(n));
+            }
+            close(fd);
+            return reply;
+        };
+
+        std::string reply = exchange("GET /a%20b?q=x%2By HTTP/1.1\r\nHost: test\r\n\r\n"
+                                     "POST /b HTTP/1.1\r\nContent-Length: 5\r\nConnection: close\r\n\r\nhello");
+        size_t first = reply.find("HTTP/1.1 200 OK");
+        size_t second = reply.find("HTTP/1.1 200 OK", first + 1);
+        assert(first == 0 && second != std::string::npos);
+        assert(reply.find(R"({"body":"","path":"/a b","q":"x+y"})") < second);
+        assert(reply.find(R"({"body":"hello","path":"/b","q":""})") > second);
+
+        assert(exchange("GET /fail HTTP/1.0\r\n\r\n").find("HTTP/1.1 500") == 0);
+        assert(exchange("BROKEN\r\n\r\n").find("HTTP/1.1 400") == 0);
+        assert(exchange("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n").find("HTTP/1.1 501") == 0);
+
+        server.stop();
+        loop.join();
+        std::cout << "testHttpServer passed.\n";
+    }
+}
+
+#endif // UNIT_TEST_HPP_
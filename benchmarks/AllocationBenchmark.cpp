@@ -0,0 +1,107 @@
+// Benchmark: số lần cấp phát heap cho mỗi lần tra cứu khi đọc Student bằng getter trả về
+// bản sao (getEmail(), ...) so với accessor view (getEmailView(), ...), và khi tra chỉ mục
+// bằng std::string tạm so với std::string_view.
+//
+// Cách dùng: allocation_benchmark [số sinh viên = 100000] [số lần tra = 200]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Student.hpp"
+#include "StudentIndex.hpp"
+
+namespace {
+std::atomic<size_t> allocationCount{0};
+}
+
+// Đếm mọi lần cấp phát qua operator new của chương trình
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+std::vector<Student> generateStudents(size_t count) {
+    static const char* programs[] = {"Advanced Program", "Formal Program", "High Quality Program"};
+    std::vector<Student> students;
+    students.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string id = std::to_string(20000000 + i);
+        students.emplace_back(id, "Nguyễn Văn Sinh Viên", "01/01/2000", i % 2 ? "Male" : "Female", "FL",
+                              std::to_string(2018 + i % 6), programs[i % 3], "227 Nguyen Van Cu, Quan 5, TP.HCM",
+                              "sv" + id + "@student.university.edu.vn", "+84900000000", "Active");
+    }
+    return students;
+}
+
+// Chạy `lookups` lần tra cứu, in thời gian và số lần cấp phát trung bình mỗi lần
+template <typename Fn>
+void measure(const char* label, size_t lookups, Fn&& lookup) {
+    volatile size_t sink = 0;
+    size_t before = allocationCount.load();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i) {
+        sink = sink + lookup(i);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t allocations = allocationCount.load() - before;
+    std::printf("%-36s %10.3f us/lookup   %12.1f allocations/lookup\n", label, seconds * 1e6 / lookups,
+                static_cast<double>(allocations) / lookups);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 100000;
+    size_t lookups = argc > 2 ? std::stoul(argv[2]) : 200;
+
+    std::vector<Student> students = generateStudents(count);
+    std::vector<std::string> emails;
+    for (size_t i = 0; i < lookups; ++i) {
+        emails.push_back(students[(i * 7919) % count].getEmail());
+    }
+    std::printf("%zu students, %zu lookups\n", count, lookups);
+
+    // Quét tuần tự theo email (kiểu lambda cũ của isStudentIdExists)
+    measure("email scan, getEmail()", lookups, [&](size_t i) {
+        const std::string& email = emails[i];
+        return static_cast<size_t>(std::find_if(students.begin(), students.end(), [&](const Student& s) {
+                                       return s.getEmail() == email;
+                                   }) - students.begin());
+    });
+    measure("email scan, getEmailView()", lookups, [&](size_t i) {
+        std::string_view email = emails[i];
+        return static_cast<size_t>(std::find_if(students.begin(), students.end(), [&](const Student& s) {
+                                       return s.getEmailView() == email;
+                                   }) - students.begin());
+    });
+
+    // Tra chỉ mục phụ theo chương trình học của từng sinh viên
+    StudentIndex programIndex;
+    for (size_t slot = 0; slot < count; ++slot) {
+        programIndex.insert(students[slot].getProgram(), slot);
+    }
+    size_t indexLookups = lookups * 1000;
+    measure("program index, std::string key", indexLookups, [&](size_t i) {
+        std::string key(students[i % count].getProgram());
+        return programIndex.count(key);
+    });
+    measure("program index, string_view key", indexLookups, [&](size_t i) {
+        return programIndex.count(std::string_view(students[i % count].getProgram()));
+    });
+
+    return 0;
+}
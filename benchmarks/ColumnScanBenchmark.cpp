@@ -0,0 +1,96 @@
+// Benchmark: quét một trường trên std::vector<Student> (AoS) so với kho cột
+// StudentColumns (SoA: mã từ điển và thời điểm tạo).
+//
+// Cách dùng: column_scan_benchmark [số sinh viên = 1000000] [số lần lặp = 10]
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Student.hpp"
+#include "StudentColumns.hpp"
+
+namespace {
+
+std::vector<Student> generateStudents(size_t count) {
+    static const char* names[] = {"Nguyễn Văn An", "Trần Thị Bình", "Lê Hoàng Cường", "Phạm Minh Đức"};
+    static const char* faculties[] = {"FL", "FBE", "FJPN", "FFR"};
+    static const char* programs[] = {"Advanced Program", "Formal Program", "High Quality Program"};
+    static const char* statuses[] = {"Active", "Graduated", "Leave", "Absent"};
+    std::vector<Student> students;
+    students.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        students.emplace_back(std::to_string(20000000 + i), names[i % 4], "01/01/2000", i % 2 ? "Male" : "Female",
+                              faculties[i % 4], std::to_string(2018 + i % 6), programs[i % 3],
+                              "227 Nguyen Van Cu, Phuong 4, Quan 5, TP.HCM",
+                              "sv" + std::to_string(i) + "@student.university.edu.vn",
+                              "+84" + std::to_string(900000000 + i % 99999999), statuses[i % 4]);
+        students.back().setCreationTime(std::chrono::system_clock::from_time_t(1600000000 + i));
+    }
+    return students;
+}
+
+template <typename Fn>
+double bestOf(int iterations, Fn&& fn) {
+    double best = 1e30;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+void report(const char* label, double aos, double soa, size_t rows) {
+    std::printf("%-26s AoS %8.2f ms (%6.2f ns/row)   SoA %8.2f ms (%6.2f ns/row)   x%.1f\n", label,
+                aos * 1e3, aos * 1e9 / rows, soa * 1e3, soa * 1e9 / rows, aos / soa);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 10;
+
+    std::vector<Student> students = generateStudents(count);
+    StudentColumns columns;
+    columns.reserve(count);
+    for (const Student& student : students) {
+        columns.append(student);
+    }
+    std::printf("%zu students, sizeof(Student) = %zu bytes\n", count, sizeof(Student));
+
+    volatile size_t sink = 0;
+    uint32_t active = StudentDictionaries::getInstance().status.intern("Active");
+
+    // Đếm theo tình trạng (trường mã)
+    double aos = bestOf(iterations, [&] {
+        size_t counts[8] = {};
+        for (const Student& student : students) ++counts[student.getStatusCode() & 7];
+        sink = sink + counts[active & 7];
+    });
+    double soa = bestOf(iterations, [&] {
+        size_t counts[8] = {};
+        for (uint32_t code : columns.status) ++counts[code & 7];
+        sink = sink + counts[active & 7];
+    });
+    report("status counts", aos, soa, count);
+
+    // Lọc theo thời điểm tạo
+    const int64_t since = 1600000000 + static_cast<int64_t>(count / 2);
+    const auto sinceTime = std::chrono::system_clock::from_time_t(since);
+    aos = bestOf(iterations, [&] {
+        size_t matches = 0;
+        for (const Student& student : students) matches += student.getCreationTime() >= sinceTime;
+        sink = sink + matches;
+    });
+    soa = bestOf(iterations, [&] {
+        size_t matches = 0;
+        for (int64_t seconds : columns.creationSeconds) matches += seconds >= since;
+        sink = sink + matches;
+    });
+    report("created-since filter", aos, soa, count);
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Benchmark: tách trường CSV bằng getline/stringstream (cách cũ) so với
+// RecordIO::importFromCSV dùng bộ quét vô hướng / SSE2 / AVX2.
+//
+// Cách dùng: csv_split_benchmark [số dòng = 2000000] [file = bench_students.csv]
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "RecordIO.hpp"
+#include "CsvScanner.hpp"
+
+namespace {
+
+void generateStudentsCSV(const std::string& filename, size_t rows) {
+    static const char* names[] = {"Nguyen Van An", "Tran Thi Binh", "Le Hoang Cuong", "Pham Minh Duc"};
+    static const char* faculties[] = {"FL", "FBE", "FJPN", "FFR"};
+    static const char* programs[] = {"Advanced Program", "Formal Program", "High Quality Program"};
+    static const char* statuses[] = {"Active", "Graduated", "Leave", "Absent"};
+    std::ofstream out(filename);
+    for (size_t i = 0; i < rows; ++i) {
+        out << (20000000 + i) << ',' << names[i % 4] << ",01/01/2000," << (i % 2 ? "Male" : "Female") << ','
+            << faculties[i % 4] << ',' << (2018 + i % 6) << ',' << programs[i % 3] << ','
+            // Một phần địa chỉ có dấu phẩy nên phải nằm trong dấu nháy
+            << (i % 3 == 0 ? "\"227 Nguyen Van Cu, Phuong 4, Quan 5, TP.HCM\"" : "Ho Chi Minh") << ','
+            << "sv" << i << "@student.university.edu.vn,+84" << (900000000 + i % 99999999) << ','
+            << statuses[i % 4] << '\n';
+    }
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* label, size_t records, size_t fields, double seconds, double megabytes) {
+    std::printf("%-22s %10zu records %12zu fields %8.3f s %9.1f MB/s\n",
+                label, records, fields, seconds, megabytes / seconds);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t rows = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    std::string filename = argc > 2 ? argv[2] : "bench_students.csv";
+
+    generateStudentsCSV(filename, rows);
+    std::ifstream sizeProbe(filename, std::ios::binary | std::ios::ate);
+    double megabytes = static_cast<double>(sizeProbe.tellg()) / (1024.0 * 1024.0);
+    std::printf("Generated %zu rows (%.1f MB) in %s\n", rows, megabytes, filename.c_str());
+
+    {
+        // Cách cũ: getline từng dòng rồi tách bằng stringstream (không hiểu dấu nháy)
+        auto start = std::chrono::steady_clock::now();
+        std::ifstream file(filename);
+        std::string line, cell;
+        size_t records = 0, fields = 0;
+        std::vector<std::string> record;
+        while (std::getline(file, line)) {
+            record.clear();
+            std::stringstream lineStream(line);
+            while (std::getline(lineStream, cell, ',')) {
+                record.push_back(cell);
+            }
+            fields += record.size();
+            ++records;
+        }
+        report("getline+stringstream", records, fields, secondsSince(start), megabytes);
+    }
+
+    RecordIO recordIO;
+    for (CsvScanMode mode : {CsvScanMode::Scalar, CsvScanMode::SSE2, CsvScanMode::AVX2}) {
+        if (!setCsvScanMode(mode)) {
+            std::printf("%-22s not supported on this CPU\n", csvScanModeName(mode));
+            continue;
+        }
+        size_t records = 0, fields = 0;
+        auto start = std::chrono::steady_clock::now();
+        std::streambuf* saved = std::cout.rdbuf(nullptr);   // Bỏ thông báo của RecordIO
+        recordIO.importFromCSV(filename, [&](const std::vector<std::string>& record) {
+            fields += record.size();
+            ++records;
+        });
+        std::cout.rdbuf(saved);
+        std::string label = std::string("CsvParser/") + csvScanModeName(mode);
+        report(label.c_str(), records, fields, secondsSince(start), megabytes);
+    }
+
+    std::remove(filename.c_str());
+    return 0;
+}
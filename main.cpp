@@ -9,35 +9,22 @@
 #include <limits>
 #include <cassert>
 #include <cstdio>
+#include <csignal>
 
 #include "nlohmann/json.hpp"
 #include "Logger.hpp"
 #include "RecordIO.hpp"
+#include "CsvScanner.hpp"
 #include "Student.hpp"
 #include "ConfigManager.hpp"
 #include "StatusRulesManager.hpp"
+#include "HttpServer.hpp"
+#include "StudentApi.hpp"
 #include "UnitTest.hpp"
 #include "CertificateGenerator.hpp"
 
 using json = nlohmann::json;
 
-// Hàm dịch trạng thái sinh viên từ tiếng Anh sang tiếng Việt
-std::string translateStatus(const std::string &status) {
-    if (status == "Active") {
-        return "Đang theo học";
-    } else if (status == "Graduated") {
-        return "Đã tốt nghiệp";
-    } else if (status == "Leave") {
-        return "Bảo lưu";
-    } else if (status == "Absent") {
-        return "Vắng mặt";
-    } else if (status == "Post-graduated") {
-        return "Sau tốt nghiệp";
-    } else {
-        return status; // Nếu không khớp, trả về giá trị ban đầu
-    }
-}
-
 // Hàm hỗ trợ người dùng chọn mục đích xác nhận
 std::string chooseCertificatePurpose() {
     std::cout << "\nChọn mục đích xác nhận:\n";
@@ -225,7 +212,38 @@ std::pair<std::string, std::string> getVersionInfo(const std::string& filepath)
     return {version, buildDate};
 }
 
-int main() {
+// Máy chủ đang chạy ở chế độ --serve; signal handler dùng để dừng nó
+HttpServer* activeServer = nullptr;
+
+void stopServer(int) {
+    if (activeServer) {
+        activeServer->stop();
+    }
+}
+
+// Chế độ máy chủ: phục vụ các endpoint của StudentApi trên 127.0.0.1 cho đến khi nhận
+// SIGINT/SIGTERM, rồi ghi các thay đổi còn chờ ra file
+int runServer(StudentRepository& repo, uint16_t port) {
+    HttpServer server([&repo](const HttpRequest& request) { return handleStudentApiRequest(repo, request); },
+                      static_cast<size_t>(std::max(0, ConfigManager::getInstance().getServerThreads())));
+    if (!server.listen("127.0.0.1", port)) {
+        std::cerr << "Không thể mở cổng " << port << ".\n";
+        return 1;
+    }
+    activeServer = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+    std::cout << "Đang phục vụ tại http://127.0.0.1:" << server.port() << " (Ctrl+C để dừng)" << std::endl;
+    server.run();
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    activeServer = nullptr;
+    repo.flush();
+    std::cout << "Đã dừng máy chủ." << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
     auto [version, buildDate] = getVersionInfo("version_info.json");
     std::cout << "-------------------------" << std::endl;
     std::cout << "Ho Chi Minh City University of Science" << std::endl;
@@ -249,11 +267,37 @@ int main() {
     try {
         Test::testStudentSerialization();
         Test::testStudentRepository();
+        Test::testStudentIdIndex();
+        Test::testStudentSecondaryIndex();
+        Test::testStudentDictionary();
+        Test::testNameSearchIndex();
+        Test::testFuzzySearch();
+        Test::testStudentQuery();
+        Test::testStudentColumns();
+        Test::testStudentArena();
+        Test::testStudentViews();
+        Test::testStudentJournal();
+        Test::testReloadIfChanged();
+        Test::testStudentBatch();
+        Test::testPersistenceScheduler();
+        Test::testConcurrentRepository();
+        Test::testAsyncLogger();
+        Test::testStudentSnapshot();
+        Test::testAtomicFile();
+        Test::testStudentJsonReader();
         Test::testRecordIO_CSV();
+        Test::testCsvQuoting();
+        Test::testCsvScanner();
         Test::testRecordIO_JSON();
+        Test::testJsonOutputStyle();
+        Test::testRecordIO_NDJSON();
+        Test::testParallelImport();
         Test::testConfigManager();
         Test::testStatusRulesManager();
         Test::testConcreteStudentValidator();
+        Test::testValidatorConfigRefresh();
+        Test::testStudentApi();
+        Test::testHttpServer();
 
         std::cout << "Tất cả unit test đã chạy thành công.\n";
     } catch (const std::exception& ex) {
@@ -265,10 +309,28 @@ int main() {
     }
     #endif
 
+    // ./app --serve [port]: chạy máy chủ HTTP thay cho menu
+    if (argc > 1 && std::string(argv[1]) == "--serve") {
+        int port = ConfigManager::getInstance().getServerPort();
+        if (argc > 2) {
+            try {
+                port = std::stoi(argv[2]);
+            } catch (const std::exception&) {
+                port = -1;
+            }
+        }
+        if (port < 0 || port > 65535) {
+            std::cerr << "Cổng không hợp lệ.\n";
+            return 1;
+        }
+        return runServer(repo, static_cast<uint16_t>(port));
+    }
+
     int choice;
     do {
-        repo.loadStudentDataFromFile();
-        repo.displayAllStudents();
+        // Dữ liệu được giữ trong bộ nhớ; chỉ nạp lại khi file bị sửa từ bên ngoài
+        repo.reloadIfChanged();
+        repo.displaySummary();
         std::cout << "\n--- MENU ---" << std::endl;
         std::cout << "1. Thêm sinh viên" << std::endl;
         std::cout << "2. Xóa sinh viên" << std::endl;
@@ -290,6 +352,11 @@ int main() {
         std::cout << "18. Xóa Tình trạng" << std::endl;
         std::cout << "19. Xóa Chương trình đào tạo" << std::endl;
         std::cout << "20. Bật/Tắt quy định" << std::endl;
+        std::cout << "21. Xem danh sách sinh viên (phân trang)" << std::endl;
+        std::cout << "22. Định dạng lưu trữ dữ liệu (JSON/Nhị phân)" << std::endl;
+        std::cout << "23. Tìm kiếm gần đúng (MSSV/Họ tên gõ sai)" << std::endl;
+        std::cout << "24. Truy vấn nâng cao (nhiều điều kiện)" << std::endl;
+        std::cout << "25. Nhập/Xuất NDJSON (mỗi dòng một sinh viên)" << std::endl;
         std::cout << "0. Thoát" << std::endl;
         std::cout << "Nhập lựa chọn của bạn: ";
         std::cin >> choice;
@@ -313,10 +380,11 @@ int main() {
                 std::cout << "Nhập MSSV của sinh viên cần cập nhật: ";
                 std::getline(std::cin, id);
 
-                Student* student = repo.findStudent(id);
+                const Student* student = repo.findStudent(id);
                 if (student) {
-                    if (getUpdatedStudentInfoFromUser(student, validator)) {
-                        repo.saveStudentDataToFile();
+                    // Chỉnh sửa trên bản sao để chỉ mục MSSV chỉ thay đổi khi cập nhật thành công
+                    Student edited = *student;
+                    if (getUpdatedStudentInfoFromUser(&edited, validator) && repo.updateStudent(id, edited)) {
                         std::cout << "Thông tin sinh viên đã được cập nhật.\n";
                     } else {
                         std::cout << "Cập nhật thông tin sinh viên bị hủy bỏ do không hợp lệ.\n";
@@ -330,13 +398,23 @@ int main() {
                 std::string keyword;
                 std::cout << "Nhập từ khóa tìm kiếm (Họ tên hoặc MSSV): ";
                 std::getline(std::cin, keyword);
-                std::vector<Student> results = repo.searchStudents(keyword);
+                // Tìm theo MSSV trước, sau đó theo họ tên (không phân biệt hoa thường/dấu)
+                const size_t maxResults = 50;
+                std::vector<Student> results;
+                if (const Student* byId = repo.findStudent(keyword)) {
+                    results.push_back(*byId);
+                } else {
+                    results = repo.searchByName(keyword, NameMatchMode::Substring, maxResults + 1);
+                }
                 if (!results.empty()) {
                     std::cout << "Kết quả tìm kiếm:\n";
-                    for (const Student& student : results) {
-                        student.displayInfo();
+                    for (size_t i = 0; i < results.size() && i < maxResults; ++i) {
+                        results[i].displayInfo();
                         std::cout << "----------\n";
                     }
+                    if (results.size() > maxResults) {
+                        std::cout << "Chỉ hiển thị " << maxResults << " kết quả đầu tiên, hãy nhập từ khóa cụ thể hơn.\n";
+                    }
                 } else {
                     std::cout << "Không tìm thấy sinh viên nào phù hợp.\n";
                 }
@@ -346,8 +424,8 @@ int main() {
                 std::string filename;
                 std::cout << "Nhập tên file CSV để nhập: ";
                 std::getline(std::cin, filename);
-                std::vector<std::vector<std::string>> importedData = recordIO.importFromCSV(filename);
-                repo.importStudentsFromStrings(importedData);
+                // Nhập theo luồng: đọc, kiểm tra song song và thêm vào repository theo thứ tự
+                repo.importStudentsFromCSV(filename);
                 break;
             }
             case 6: {
@@ -371,7 +449,7 @@ int main() {
                 std::cout << "Nhập tên file JSON để xuất: ";
                 std::getline(std::cin, filename);
                 std::vector<std::vector<std::string>> allStudents = repo.getAllStudentsAsStrings();
-                recordIO.exportToJSON(filename, allStudents);
+                recordIO.exportToJSON(filename, allStudents, ConfigManager::getInstance().getJsonOutputStyle());
                 break;
             }
             case 9: {
@@ -380,7 +458,12 @@ int main() {
                 std::getline(std::cin, faculty);
                 std::getline(std::cin, name);
 
-                std::vector<Student> results = repo.searchStudents(faculty, name);
+                StudentQuery query;
+                query.predicates.push_back({StudentField::Faculty, QueryOp::Equal, faculty});
+                if (!name.empty()) {
+                    query.predicates.push_back({StudentField::Name, QueryOp::Contains, name});
+                }
+                std::vector<Student> results = repo.query(query);
                 if (!results.empty()) {
                     std::cout << "Kết quả tìm kiếm:\n";
                     for (const auto& s : results) {
@@ -490,56 +573,27 @@ int main() {
                 std::cout << "Nhập MSSV: ";
                 std::getline(std::cin, studentID);
 
-                // Mở file JSON (database) chứa dữ liệu sinh viên
-                std::ifstream inFile("students.json");
-                if (!inFile.is_open()) {
-                    std::cerr << "Error: Không thể mở file database (students.json).\n";
-                    return 1;
-                }
-
-                json db;
-                try {
-                    inFile >> db;
-                } catch (const json::exception &e) {
-                    std::cerr << "Error parsing JSON: " << e.what() << "\n";
-                    return 1;
-                }
-                inFile.close();
-
                 // Tìm sinh viên theo MSSV
-                bool found = false;
-                CertificateData cert;
-                for (const auto &record : db) {
-                    if (record.contains("id") && record["id"].get<std::string>() == studentID) {
-                        found = true;
-                        // Lấy thông tin sinh viên từ record JSON
-                        cert.studentID       = record["id"].get<std::string>();
-                        cert.studentName     = record["name"].get<std::string>();
-                        cert.studentDOB      = record["dob"].get<std::string>();
-                        cert.studentGender   = record["gender"].get<std::string>();
-                        cert.studentFaculty  = record["faculty"].get<std::string>();
-                        cert.studentProgram  = record["program"].get<std::string>();
-                        cert.studentCourse   = record["course"].get<std::string>();
-                        // Nếu record có trường "status", chuyển đổi sang tiếng Việt
-                        if (record.contains("status"))
-                            cert.studentStatus = translateStatus(record["status"].get<std::string>());
-                        else
-                            cert.studentStatus = "Không xác định";
-
-                        // Thông tin trường (có thể thay đổi theo cấu hình)
-                        cert.schoolName      = "KHOA HỌC TỰ NHIÊN";
-                        cert.schoolAddress   = "227 NGUYỄN VĂN CỪ, PHƯỜNG 4, QUẬN 5 TP.HCM";
-                        cert.schoolPhone     = "(028) 38353448";
-                        cert.schoolEmail     = "contact@hcmus.edu.vn";
-
-                        // Lấy mục đích xác nhận thông qua hàm giao diện
-                        cert.confirmationPurpose = chooseCertificatePurpose();
-                        std::cout << "Nhập ngày hiệu lực (DD/MM/YYYY): ";
-                        std::getline(std::cin, cert.effectiveDate);
-                        std::cout << "Nhập ngày cấp (DD/MM/YYYY): ";
-                        std::getline(std::cin, cert.issueDate);
-                        break;
-                    }
+                const Student* student = repo.findStudent(studentID);
+                bool found = student != nullptr;
+                CertificateData cert = defaultCertificateData();
+                if (found) {
+                    // Lấy thông tin sinh viên từ repository
+                    cert.studentID       = student->getId();
+                    cert.studentName     = student->getName();
+                    cert.studentDOB      = student->getDob();
+                    cert.studentGender   = student->getGender();
+                    cert.studentFaculty  = student->getFaculty();
+                    cert.studentProgram  = student->getProgram();
+                    cert.studentCourse   = student->getCourse();
+                    cert.studentStatus   = translateStatus(student->getStatus());
+
+                    // Lấy mục đích xác nhận thông qua hàm giao diện
+                    cert.confirmationPurpose = chooseCertificatePurpose();
+                    std::cout << "Nhập ngày hiệu lực (DD/MM/YYYY): ";
+                    std::getline(std::cin, cert.effectiveDate);
+                    std::cout << "Nhập ngày cấp (DD/MM/YYYY): ";
+                    std::getline(std::cin, cert.issueDate);
                 }
 
                 if (!found) {
@@ -641,13 +695,136 @@ int main() {
                 std::cout << "Các quy định hiện tại: " << (flag ? "BẬT" : "TẮT") << ".\n";
                 break;
             }
+            case 21: { // Xem danh sách sinh viên theo trang
+                const size_t pageSize = 20;
+                size_t pageCount = std::max<size_t>(1, (repo.getStudentCount() + pageSize - 1) / pageSize);
+                size_t page = 1;
+                while (true) {
+                    repo.displayStudentsPage(page, pageSize);
+                    std::string input = repo.getSafeInput("Nhập số trang (1-" + std::to_string(pageCount) + "), 'n' trang sau, 'p' trang trước, 'q' để thoát: ");
+                    if (input == "q" || input == "Q") {
+                        break;
+                    } else if (input == "n" || input == "N") {
+                        page = std::min(page + 1, pageCount);
+                    } else if (input == "p" || input == "P") {
+                        page = page > 1 ? page - 1 : 1;
+                    } else {
+                        try {
+                            size_t requested = std::stoul(input);
+                            if (requested >= 1 && requested <= pageCount) {
+                                page = requested;
+                            } else {
+                                std::cout << "Số trang không hợp lệ.\n";
+                            }
+                        } catch (std::exception&) {
+                            std::cout << "Lựa chọn không hợp lệ.\n";
+                        }
+                    }
+                }
+                break;
+            }
+            case 22: { // Định dạng lưu trữ dữ liệu sinh viên
+                int formatChoice;
+                std::cout << "\n--- Định dạng lưu trữ (hiện tại: " << ConfigManager::getInstance().getStorageFormat() << ") ---" << std::endl;
+                std::cout << "1. Chuyển file JSON sang snapshot nhị phân" << std::endl;
+                std::cout << "2. Chuyển snapshot nhị phân sang file JSON" << std::endl;
+                std::cout << "3. Chọn định dạng lưu trữ chính (json/binary)" << std::endl;
+                std::cout << "4. Chọn kiểu ghi JSON (pretty/compact/lines, hiện tại: "
+                          << jsonOutputStyleName(ConfigManager::getInstance().getJsonOutputStyle()) << ")" << std::endl;
+                std::cout << "Nhập lựa chọn của bạn: ";
+                std::cin >> formatChoice;
+                std::cin.ignore();
+
+                repo.flush(); // Các file dữ liệu có thể được đọc trực tiếp bên dưới
+                if (formatChoice == 1) {
+                    std::string source = repo.getSafeInput("Nhập tên file JSON nguồn (ví dụ: students.json): ");
+                    std::string target = repo.getSafeInput("Nhập tên file nhị phân đích (ví dụ: students.bin): ");
+                    std::cout << (convertJsonToSnapshot(source, target) ? "Chuyển đổi thành công.\n" : "Chuyển đổi thất bại.\n");
+                } else if (formatChoice == 2) {
+                    std::string source = repo.getSafeInput("Nhập tên file nhị phân nguồn (ví dụ: students.bin): ");
+                    std::string target = repo.getSafeInput("Nhập tên file JSON đích (ví dụ: students.json): ");
+                    std::cout << (convertSnapshotToJson(source, target) ? "Chuyển đổi thành công.\n" : "Chuyển đổi thất bại.\n");
+                } else if (formatChoice == 3) {
+                    std::string format = repo.getSafeInput("Nhập định dạng (json/binary): ");
+                    if (format == "json" || format == "binary") {
+                        repo.setStorageFormat(format);
+                    } else {
+                        std::cout << "Định dạng không hợp lệ.\n";
+                    }
+                } else if (formatChoice == 4) {
+                    std::string name = repo.getSafeInput("Nhập kiểu ghi (pretty/compact/lines): ");
+                    JsonOutputStyle style;
+                    if (parseJsonOutputStyle(name, style)) {
+                        repo.setJsonOutputStyle(style);
+                    } else {
+                        std::cout << "Kiểu ghi không hợp lệ.\n";
+                    }
+                } else {
+                    std::cout << "Lựa chọn không hợp lệ.\n";
+                }
+                break;
+            }
+            case 23: { // Tìm kiếm gần đúng theo MSSV hoặc họ tên
+                std::string keyword = repo.getSafeInput("Nhập MSSV hoặc họ tên (có thể gõ sai): ");
+                std::vector<Student> results = repo.fuzzySearch(keyword, 10);
+                if (!results.empty()) {
+                    std::cout << "Các sinh viên gần đúng nhất:\n";
+                    for (const Student& student : results) {
+                        student.displayInfo();
+                        std::cout << "----------\n";
+                    }
+                } else {
+                    std::cout << "Không tìm thấy sinh viên nào phù hợp.\n";
+                }
+                break;
+            }
+            case 24: { // Truy vấn nhiều điều kiện, ví dụ: status=Active AND course>=2020 LIMIT 20
+                std::cout << "Cú pháp: <trường><toán tử><giá trị> [AND ...] [LIMIT n] [OFFSET m]\n";
+                std::cout << "Trường: id, name, dob, gender, faculty, course, program, address, email, phone, status\n";
+                std::cout << "Toán tử: =, !=, <, <=, >, >=, ~ (chứa, không phân biệt dấu)\n";
+                std::string text = repo.getSafeInput("Nhập truy vấn: ");
+                StudentQuery query;
+                std::string error;
+                if (!parseStudentQuery(text, query, error)) {
+                    std::cout << "Truy vấn không hợp lệ: " << error << "\n";
+                    break;
+                }
+                QueryStats stats;
+                std::vector<Student> results = repo.query(query, &stats);
+                for (const Student& student : results) {
+                    student.displayInfo();
+                    std::cout << "----------\n";
+                }
+                std::cout << results.size() << " kết quả (chỉ mục: " << stats.index
+                          << ", đã kiểm tra " << stats.candidates << " bản ghi).\n";
+                break;
+            }
+            case 25: { // NDJSON: ghi/đọc theo luồng, dùng cho file trao đổi lớn
+                int ndjsonChoice;
+                std::cout << "1. Xuất NDJSON\n2. Nhập NDJSON\nNhập lựa chọn của bạn: ";
+                std::cin >> ndjsonChoice;
+                std::cin.ignore();
+                if (ndjsonChoice == 1) {
+                    std::string filename = repo.getSafeInput("Nhập tên file NDJSON để xuất: ");
+                    if (repo.exportStudentsToNDJSON(filename)) {
+                        std::cout << "Đã xuất NDJSON: " << filename << "\n";
+                    }
+                } else if (ndjsonChoice == 2) {
+                    std::string filename = repo.getSafeInput("Nhập tên file NDJSON để nhập: ");
+                    repo.importStudentsFromNDJSON(filename);
+                } else {
+                    std::cout << "Lựa chọn không hợp lệ.\n";
+                }
+                break;
+            }
             case 0:
+                repo.flush();
                 std::cout << "Thoát chương trình.\n";
                 break;
             default:
                 std::cout << "Lựa chọn không hợp lệ. Vui lòng thử lại.\n";
         }
     } while (choice != 0);
-    delete validator;
+    // validator thuộc quyền sở hữu của StudentRepository (giải phóng trong destructor)
     return 0;
 }